@@ -0,0 +1,131 @@
+/*******************************************************************************
+  File: batch_insert.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Batch insertion maintains an already-sorted array as small batches of new
+  elements arrive. Rather than re-sorting the whole array, the batch is sorted
+  on its own and then merged into the sorted array from the back. The array
+  must have room for the batch after its sorted elements, so the merge can be
+  done in place without a temporary buffer.
+
+  For each element of the batch, starting with the largest, the position it
+  belongs at in the sorted array is found by "galloping": the search steps
+  backwards from the end of the unmerged portion by 1, 2, 4, ... elements until
+  it overshoots, and then binary searches the last step. The run of elements
+  that belong after the batch element is moved up in one block. The cost of
+  each insertion is therefore proportional to the logarithm of the distance
+  moved rather than the length of the array, and the total cost is
+  proportional to the batch plus the displaced tail.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "sort.h"
+
+/**
+ * `BATCH_INSERTION_MAX`
+ *
+ *   Largest batch that is sorted with insertion sort instead of three-way
+ *   quicksort, which takes the middle element as its pivot and so stays fast
+ *   on batches that are already sorted or full of duplicates.
+ */
+#define BATCH_INSERTION_MAX 16
+
+/**
+ * `gallop`
+ *
+ *   Finds the index of the first element in a sorted array that is greater
+ *   than a value, searching backwards from the end of the array.
+ *
+ * @param arr
+ *   The sorted array to be searched.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param val
+ *   The value to search for.
+ *
+ * @return
+ *   The index at which the value can be inserted after any equal elements.
+ */
+static inline size_t gallop(const int * const arr, const size_t len,
+  const int val) {
+  size_t lo = 0;     /* Lower bound of the search range. */
+  size_t hi = len;   /* Upper bound of the search range. */
+  size_t step = 1;   /* Distance back from the upper bound. */
+  size_t mid;
+
+  /*** Step backwards by doubling distances until an element that is not ***/
+  /*** greater than the value is found.                                   ***/
+  while(step <= hi && LESS(val, arr[hi - step])) {
+    hi -= step;
+    step <<= 1;
+  }
+  if(step <= hi) {
+    lo = hi - step + 1;
+  }
+
+  /*** Binary search the remaining range. ***/
+  while(lo < hi) {
+    mid = lo + ((hi - lo) >> 1);
+    if(LESS(val, arr[mid])) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+
+/**
+ * `batch_insert`
+ *
+ *   Inserts a batch of elements into an already-sorted array.
+ *
+ * @param arr
+ *   The sorted array, with room for `batch_len` more elements after `len`.
+ *
+ * @param len
+ *   The number of sorted elements in the array.
+ *
+ * @param batch
+ *   The elements to be inserted. The batch is sorted in place.
+ *
+ * @param batch_len
+ *   The length of the batch.
+ */
+void batch_insert(int * const arr, const size_t len, int * const batch,
+  const size_t batch_len) {
+  size_t i = len;        /* Number of sorted elements not yet merged. */
+  size_t j = batch_len;  /* Number of batch elements not yet merged. */
+  size_t pos;            /* Insertion position of the current element. */
+
+  /*** Sort the batch. ***/
+  if(batch_len <= BATCH_INSERTION_MAX) {
+    insertion_sort(batch, batch_len);
+  }
+  else {
+    quicksort_3way(batch, batch_len);
+  }
+
+  /*** Merge the batch into the array, largest elements first. ***/
+  while(j > 0) {
+
+    /*** Find where the largest remaining batch element belongs and move ***/
+    /*** the elements after it up to make room.                         ***/
+    pos = gallop(arr, i, batch[j - 1]);
+    memmove((arr + pos + j), (arr + pos), sizeof(int) * (i - pos));
+    MOVED(i - pos);
+    i = pos;
+
+    /*** Place the batch element. ***/
+    j--;
+    arr[i + j] = batch[j];
+    MOVED(1);
+  }
+}
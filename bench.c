@@ -0,0 +1,1632 @@
+/*******************************************************************************
+  File: bench.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Scaling benchmark for the sorting algorithms. Every algorithm is run on every
+  input distribution for array lengths from 10 up to a maximum on a log scale,
+  and with 1 up to a maximum number of threads. With `t` threads, each thread
+  sorts its own copies of the input at the same time, so the throughput shows
+  how well an algorithm scales when the machine is shared.
+
+  Algorithms are skipped above `QUADRATIC_MAX_N` elements on the distributions
+  they take quadratic time on.
+
+  Small arrays are sorted as a batch of copies laid out back to back, so each
+  timed run sorts at least `BENCH_MIN_ELEMS` elements. The best of
+  `BENCH_REPS` runs is reported.
+
+  Stable key-value sorting is benchmarked separately on one thread, with
+  64-bit keys and row ids stored as an array of pairs (merge sort and radix
+  sort) or as separate arrays of keys and row ids (radix sort), so the layouts
+  can be compared at each length.
+
+  The NUMA-aware parallel sort is run on the random input with 1 up to the
+  maximum number of threads sorting one array together, once with its threads
+  pinned across every node and sorting in memory they first touch, and once as
+  the NUMA-oblivious baseline, with the chunks sorted in place in the input
+  and scratch memory allocated and touched by the calling thread, to show the
+  gain from keeping memory on the node that uses it. Lengths the sort does not
+  split between threads are skipped, since every row would be the same.
+
+  A benchmark that needs more memory than the machine has is skipped rather
+  than failed, so the largest lengths can be run on any machine. For
+  `sort_auto`, the algorithm it selected is recorded with each result.
+
+  Segmented sort is run on the random input divided into segments of random
+  lengths, mostly small enough for its sorting networks and insertion sort,
+  with 1 up to the maximum number of threads sharing the segments.
+
+  Batch insertion is run on one thread, merging a batch of random elements,
+  1% of the length, into the random input after it is sorted. The merged
+  array is checked against the fingerprint of the array and the batch.
+
+  Results are written as CSV. If a baseline CSV is given, the throughput of each
+  result is compared to the baseline result with the same length,
+  distribution, algorithm, and thread count, and the program exits with a
+  non-zero status if any of them regressed by more than the threshold, or if
+  a baseline result has no match in the new run.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sort.h"
+
+#define DEF_MAX_N 10000000UL
+#define DEF_REGRESS_PCT 10.0
+#define BENCH_MIN_ELEMS (1UL << 16)
+#define BENCH_REPS 3
+#define QUADRATIC_MAX_N (1UL << 14)
+#define MAX_THREADS 256
+#define NAME_LEN 32
+#define SEGMENT_SMALL 64     /* Longest of most segments. */
+#define SEGMENT_LARGE 4096   /* Longest of one in `SEGMENT_SMALL` segments. */
+#define BATCH_DIV 100        /* Length of the array per element of a batch. */
+
+/* Types **********************************************************************/
+
+/**
+ * `algorithm`
+ *
+ *   A sorting algorithm to be benchmarked.
+ */
+typedef struct {
+  const char *name;
+  void (*sort)(int * const, const size_t);
+  unsigned int quadratic;  /* Distributions the algorithm is quadratic on. */
+  size_t scratch;          /* Most scratch memory, in halves of the array. */
+} algorithm;
+
+/**
+ * `dist_index`
+ *
+ *   Index of each distribution in `DISTRIBUTIONS`.
+ */
+enum dist_index {
+  DIST_RANDOM,
+  DIST_SORTED,
+  DIST_REVERSED,
+  DIST_NEARLY,
+  DIST_FEW_UNIQUE,
+  DIST_WIDE
+};
+
+/**
+ * `ON`
+ *
+ *   Macro to build the set of distributions an algorithm is quadratic on.
+ */
+#define ON(d) (1u << (d))
+#define ON_ALL (~0u)
+
+/**
+ * `distribution`
+ *
+ *   A way of generating the input array.
+ */
+typedef struct {
+  const char *name;
+  void (*fill)(int * const, const size_t);
+} distribution;
+
+/**
+ * `kv_layout`
+ *
+ *   The key-value sorts, by layout, in the order of `KV_NAMES`.
+ */
+typedef enum {
+  KV_AOS_MERGE,
+  KV_AOS_RADIX,
+  KV_SOA_RADIX
+} kv_layout;
+
+/**
+ * `placement`
+ *
+ *   A way of placing the threads of the NUMA-aware parallel sort.
+ */
+typedef struct {
+  const char *name;
+  size_t nodes;  /* Number of nodes given to numa_sort_ctx. */
+  int flags;     /* Flags given to numa_sort_ctx. */
+} placement;
+
+/**
+ * `result`
+ *
+ *   One row of benchmark results.
+ */
+typedef struct {
+  size_t n;
+  char dist[NAME_LEN];
+  char algo[NAME_LEN];
+  size_t threads;
+  double ns_per_elem;  /* Best time per element on one thread. */
+  double melem_per_s;  /* Millions of elements sorted per second by all. */
+  char choice[NAME_LEN];  /* Algorithm selected by `sort_auto`, or "-". */
+} result;
+
+/**
+ * `timing`
+ *
+ *   A benchmark timed by `time_best`. It is the first member of the state of
+ *   each kind of benchmark, so the callbacks can get the rest of the state.
+ */
+typedef struct timing {
+  void (*lay_out)(struct timing * const, const size_t);  /* Fresh copy. */
+  int (*sort)(struct timing * const, const size_t);  /* Non-zero on failure. */
+  size_t copies;               /* Copies sorted in each timed run. */
+  pthread_barrier_t *barrier;  /* Waited on before each run, or NULL. */
+  int skipped;                 /* Non-zero to only wait on the barrier. */
+} timing;
+
+/**
+ * `worker`
+ *
+ *   The state of one benchmark thread.
+ */
+typedef struct {
+  timing tm;
+  const algorithm *algo;
+  const int *input;
+  const sort_fingerprint *fp;  /* Fingerprint of the input. */
+  size_t n;
+  int *buf;        /* The copies. */
+  double best_ns;  /* Best time to sort all of the copies. */
+  int choice;      /* Algorithm selected by `sort_auto`, or -1. */
+  int failed;      /* Non-zero if sorting failed. */
+} worker;
+
+/**
+ * `kv_bench`
+ *
+ *   The state of a key-value sort benchmark.
+ */
+typedef struct {
+  timing tm;
+  kv_layout layout;
+  const unsigned long long *keys;  /* The input keys. */
+  size_t n;
+  sort_kv *pairs;                  /* The copies as pairs, or NULL. */
+  unsigned long long *ks, *vs;     /* The copies as two arrays, or NULL. */
+  sort_ctx ctx;
+} kv_bench;
+
+/**
+ * `numa_bench`
+ *
+ *   The state of a NUMA-aware parallel sort benchmark.
+ */
+typedef struct {
+  timing tm;
+  const placement *place;
+  const int *input;
+  size_t n;
+  size_t threads;
+  int *arr;  /* The copies. */
+  sort_ctx ctxs[NUMA_MAX_THREADS];
+} numa_bench;
+
+/**
+ * `segment_bench`
+ *
+ *   The state of a segmented sort benchmark.
+ */
+typedef struct {
+  timing tm;
+  const int *input;
+  const size_t *offsets;  /* The segments of the input. */
+  size_t segs;            /* The number of segments. */
+  size_t n;
+  size_t threads;
+  int *arr;  /* The copies. */
+  sort_ctx ctxs[SEGMENT_MAX_THREADS];
+} segment_bench;
+
+/**
+ * `batch_bench`
+ *
+ *   The state of a batch insertion benchmark.
+ */
+typedef struct {
+  timing tm;
+  const int *sorted;  /* The sorted array. */
+  const int *batch;   /* The batch to be inserted. */
+  size_t n;           /* The length of the sorted array. */
+  size_t b;           /* The length of the batch. */
+  int *arr;           /* The copies of the array, with room for the batch. */
+  int *batches;       /* The copies of the batch. */
+} batch_bench;
+
+/* Function declarations ******************************************************/
+
+static void print_usage(const char * const);
+static int fits(const size_t);
+static void auto_sort(int * const, const size_t);
+static void fill_random(int * const, const size_t);
+static void fill_sorted(int * const, const size_t);
+static void fill_reversed(int * const, const size_t);
+static void fill_nearly(int * const, const size_t);
+static void fill_few_unique(int * const, const size_t);
+static void fill_wide(int * const, const size_t);
+static void fill_keys(unsigned long long * const, const size_t, const int);
+static size_t fill_offsets(size_t * const, const size_t);
+static double time_best(timing * const);
+static void lay_out_worker(timing * const, const size_t);
+static int sort_worker(timing * const, const size_t);
+static void *run_worker(void *);
+static int run(const algorithm * const, const int * const,
+  const sort_fingerprint * const, const size_t, const size_t,
+  result * const);
+static void lay_out_kv(timing * const, const size_t);
+static int sort_kv_copy(timing * const, const size_t);
+static int run_kv(const kv_layout, const int, const size_t, result * const);
+static void lay_out_numa(timing * const, const size_t);
+static int sort_numa(timing * const, const size_t);
+static void lay_out_segments(timing * const, const size_t);
+static int sort_segments(timing * const, const size_t);
+static void lay_out_batch(timing * const, const size_t);
+static int sort_batch(timing * const, const size_t);
+static int run_numa(const placement * const, const int * const,
+  const sort_fingerprint * const, const size_t, const size_t,
+  result * const);
+static int run_segments(const int * const, const sort_fingerprint * const,
+  const size_t, const size_t, result * const);
+static int run_batch(const int * const, const size_t, result * const);
+static result *next_result(result ** const, const size_t, size_t * const);
+static void write_result(FILE * const, const result * const);
+static size_t load_results(const char * const, result ** const);
+static int same_case(const result * const, const result * const);
+static int compare(const result * const, const size_t, const result * const,
+  const size_t, const double);
+
+/* Global variables ***********************************************************/
+
+/* Algorithm selected by the last call to `auto_sort` on this thread, or -1. */
+static _Thread_local int auto_choice = -1;
+
+/* Algorithms and distributions ***********************************************/
+
+static const algorithm ALGORITHMS[] = {
+  { "selection_sort", selection_sort, ON_ALL, 0 },
+  { "insertion_sort", insertion_sort, ON_ALL & ~ON(DIST_SORTED), 0 },
+  { "merge_sort",     merge_sort,     0, 1 },
+  { "quicksort",      quicksort,      ON(DIST_SORTED) | ON(DIST_REVERSED)
+                                      | ON(DIST_NEARLY) | ON(DIST_FEW_UNIQUE),
+                                      0 },
+  { "quicksort_3way", quicksort_3way, 0, 0 },
+  { "heapsort",       heapsort,       ON_ALL, 0 },
+  { "radix_lsd_sort", radix_lsd_sort, 0, 2 },
+  { "sort_auto",      auto_sort,      0, 2 }
+};
+
+static const distribution DISTRIBUTIONS[] = {
+  /* In the order of `dist_index`. */
+  { "random",     fill_random },
+  { "sorted",     fill_sorted },
+  { "reversed",   fill_reversed },
+  { "nearly",     fill_nearly },
+  { "few_unique", fill_few_unique },
+  { "wide",       fill_wide }
+};
+
+static const char * const KV_NAMES[] = {
+  "merge_sort_kv", "radix_lsd_sort_kv", "radix_lsd_sort_kv_soa"
+};
+
+static const char * const KV_DISTRIBUTIONS[] = {
+  "kv_random",  /* Keys from the whole 64-bit range. */
+  "kv_dense"    /* Keys less than the length, with duplicates. */
+};
+
+static const placement PLACEMENTS[] = {
+  { "numa_sort",      0, 0 },                  /* Pinned, memory local. */
+  { "numa_oblivious", 1, NUMA_SORT_IN_PLACE }  /* Memory from the caller. */
+};
+
+/* Main ***********************************************************************/
+
+int main(int argc, char **argv) {
+  size_t max_n = DEF_MAX_N;         /* Largest array length. */
+  size_t max_threads;               /* Largest number of threads. */
+  double regress_pct = DEF_REGRESS_PCT;
+  const char *out_path = "bench_results.csv";
+  const char *base_path = NULL;
+  result *results = NULL, *baseline = NULL;
+  size_t nresults = 0, nbaseline, cap = 0;
+  size_t n, d, a, t;
+  result *res;
+  int *input;
+  sort_fingerprint fp;
+  FILE *out;
+  int opt, r, status = 0;
+
+  max_threads = (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+
+  /*** Parse the options. ***/
+  while((opt = getopt(argc, argv, "n:t:o:b:r:")) != -1) {
+    switch(opt) {
+      case 'n': max_n = strtoul(optarg, NULL, 10); break;
+      case 't': max_threads = strtoul(optarg, NULL, 10); break;
+      case 'o': out_path = optarg; break;
+      case 'b': base_path = optarg; break;
+      case 'r': regress_pct = atof(optarg); break;
+      default:
+        print_usage(argv[0]);
+        return 2;
+    }
+  }
+  if(max_n < 10 || max_threads < 1) {
+    print_usage(argv[0]);
+    return 2;
+  }
+  if(max_threads > MAX_THREADS) {
+    max_threads = MAX_THREADS;
+  }
+
+  out = fopen(out_path, "w");
+  if(out == NULL) {
+    printf("error: failed to open %s.\n", out_path);
+    return 2;
+  }
+  fprintf(out, "n,dist,algo,threads,ns_per_elem,melem_per_s,choice\n");
+
+  /*** Sweep the array lengths on a log scale. ***/
+  for(n = 10; n <= max_n; n *= 10) {
+    input = fits(sizeof(int) * n) ? (int *)malloc(sizeof(int) * n) : NULL;
+    if(input == NULL) {
+      printf("skipping n=%lu: failed to allocate the input.\n",
+        (unsigned long)n);
+      break;
+    }
+
+    for(d = 0; d < sizeof(DISTRIBUTIONS) / sizeof(DISTRIBUTIONS[0]); d++) {
+      srand(1);
+      DISTRIBUTIONS[d].fill(input, n);
+      fingerprint_arr(input, n, &fp);
+
+      for(a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+        if((ALGORITHMS[a].quadratic & ON(d)) && n > QUADRATIC_MAX_N) {
+          continue;
+        }
+
+        for(t = 1; t <= max_threads; t++) {
+          res = next_result(&results, nresults, &cap);
+          r = run(&ALGORITHMS[a], input, &fp, n, t, res);
+          if(r != 0) {
+            printf("%s n=%lu %s %s threads=%lu: %s.\n",
+              r > 0 ? "skipping" : "error", (unsigned long)n,
+              DISTRIBUTIONS[d].name, ALGORITHMS[a].name, (unsigned long)t,
+              r > 0 ? "not enough memory" : "failed");
+            status |= r < 0;
+            break;
+          }
+          strncpy(res->dist, DISTRIBUTIONS[d].name, NAME_LEN - 1);
+          res->dist[NAME_LEN - 1] = '\0';
+          write_result(out, res);
+          nresults++;
+        }
+      }
+
+      /*** Compare the placements of the NUMA-aware parallel sort. ***/
+      for(a = 0; d == DIST_RANDOM && n >= NUMA_PARALLEL_MIN
+        && a < sizeof(PLACEMENTS) / sizeof(PLACEMENTS[0]); a++) {
+        for(t = 1; t <= max_threads && t <= NUMA_MAX_THREADS; t++) {
+          res = next_result(&results, nresults, &cap);
+          r = run_numa(&PLACEMENTS[a], input, &fp, n, t, res);
+          if(r != 0) {
+            printf("%s n=%lu %s %s threads=%lu: %s.\n",
+              r > 0 ? "skipping" : "error", (unsigned long)n,
+              DISTRIBUTIONS[d].name, PLACEMENTS[a].name, (unsigned long)t,
+              r > 0 ? "not enough memory" : "failed");
+            status |= r < 0;
+            break;
+          }
+          write_result(out, res);
+          nresults++;
+        }
+      }
+
+      /*** Sort the random input as many segments. ***/
+      for(t = 1; d == DIST_RANDOM && t <= max_threads
+        && t <= SEGMENT_MAX_THREADS; t++) {
+        res = next_result(&results, nresults, &cap);
+        r = run_segments(input, &fp, n, t, res);
+        if(r != 0) {
+          printf("%s n=%lu %s segmented_sort threads=%lu: %s.\n",
+            r > 0 ? "skipping" : "error", (unsigned long)n,
+            DISTRIBUTIONS[d].name, (unsigned long)t,
+            r > 0 ? "not enough memory" : "failed");
+          status |= r < 0;
+          break;
+        }
+        write_result(out, res);
+        nresults++;
+      }
+
+      /*** Insert a batch into the random input once it is sorted. ***/
+      if(d == DIST_RANDOM) {
+        res = next_result(&results, nresults, &cap);
+        r = run_batch(input, n, res);
+        if(r != 0) {
+          printf("%s n=%lu %s batch_insert: %s.\n",
+            r > 0 ? "skipping" : "error", (unsigned long)n,
+            DISTRIBUTIONS[d].name, r > 0 ? "not enough memory" : "failed");
+          status |= r < 0;
+        }
+        else {
+          write_result(out, res);
+          nresults++;
+        }
+      }
+    }
+    free(input);
+
+    /*** Compare the key-value layouts on one thread. ***/
+    for(d = 0; d < sizeof(KV_DISTRIBUTIONS) / sizeof(KV_DISTRIBUTIONS[0]);
+      d++) {
+      for(a = 0; a < sizeof(KV_NAMES) / sizeof(KV_NAMES[0]); a++) {
+        res = next_result(&results, nresults, &cap);
+        r = run_kv((kv_layout)a, (int)d, n, res);
+        if(r != 0) {
+          printf("%s n=%lu %s %s: %s.\n", r > 0 ? "skipping" : "error",
+            (unsigned long)n, KV_DISTRIBUTIONS[d], KV_NAMES[a],
+            r > 0 ? "not enough memory" : "failed");
+          status |= r < 0;
+          continue;
+        }
+        write_result(out, res);
+        nresults++;
+      }
+    }
+
+    /*** Stop before the length overflows. ***/
+    if(n > max_n / 10) {
+      break;
+    }
+  }
+  fclose(out);
+
+  /*** Compare to the baseline. ***/
+  if(base_path != NULL) {
+    nbaseline = load_results(base_path, &baseline);
+    if(nbaseline == 0) {
+      printf("no baseline in %s; skipping the regression check.\n", base_path);
+    }
+    else if(compare(results, nresults, baseline, nbaseline, regress_pct)) {
+      status = 1;
+    }
+    free(baseline);
+  }
+
+  free(results);
+  return status;
+}
+
+/* Function definitions *******************************************************/
+
+/**
+ * `print_usage`
+ *
+ *   Prints the usage message for this program.
+ *
+ * @param prgm_name
+ *   The name of the program as given by argv[0].
+ */
+static void print_usage(const char * const prgm_name) {
+  printf("Usage: %s [-n max_n] [-t max_threads] [-o results.csv]"
+    " [-b baseline.csv] [-r percent]\n", prgm_name);
+  printf("\t-n\tLargest array length. The default is %lu.\n", DEF_MAX_N);
+  printf("\t-t\tLargest number of threads. The default is the number of"
+    " processors.\n");
+  printf("\t-o\tFile to write the results to. The default is"
+    " bench_results.csv.\n");
+  printf("\t-b\tBaseline results to compare to.\n");
+  printf("\t-r\tThroughput regression, in percent, that fails the run. The"
+    " default is %.0f.\n\n", DEF_REGRESS_PCT);
+}
+
+/**
+ * `fits`
+ *
+ *   Checks if memory of a given size fits in the physical memory available
+ *   now, less an eighth left for the rest of the system, so that a benchmark
+ *   too large for it is skipped instead of swapping or being killed when the
+ *   memory is touched.
+ *
+ * @param bytes
+ *   The size of the memory.
+ *
+ * @return
+ *   Non-zero if the memory fits.
+ */
+static int fits(const size_t bytes) {
+  const long pages = sysconf(_SC_AVPHYS_PAGES);
+  const long page = sysconf(_SC_PAGESIZE);
+
+  if(pages <= 0 || page <= 0) {
+    return 1;
+  }
+  return bytes / (size_t)page < (size_t)pages - ((size_t)pages >> 3);
+}
+
+/**
+ * `auto_sort`
+ *
+ *   Sorts an array with `sort_auto` and records the algorithm it selected in
+ *   `auto_choice`.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+static void auto_sort(int * const arr, const size_t len) {
+  sort_profile prof;
+
+  sort_auto(arr, len, &prof);
+  auto_choice = (int)prof.algo;
+}
+
+/**
+ * `fill_random`
+ *
+ *   Fills an array with shuffled distinct values.
+ */
+static void fill_random(int * const arr, const size_t len) {
+  init_arr(arr, len);
+}
+
+/**
+ * `fill_sorted`
+ *
+ *   Fills an array with distinct values in ascending order.
+ */
+static void fill_sorted(int * const arr, const size_t len) {
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    arr[i] = (int)i;
+  }
+}
+
+/**
+ * `fill_reversed`
+ *
+ *   Fills an array with distinct values in descending order.
+ */
+static void fill_reversed(int * const arr, const size_t len) {
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    arr[i] = (int)(len - i - 1);
+  }
+}
+
+/**
+ * `fill_nearly`
+ *
+ *   Fills an array with ascending values and swaps 1% of them at random.
+ */
+static void fill_nearly(int * const arr, const size_t len) {
+  size_t i;
+
+  fill_sorted(arr, len);
+  for(i = 0; i < len / 100 + 1; i++) {
+    swap(arr, (size_t)rand() % len, (size_t)rand() % len);
+  }
+}
+
+/**
+ * `fill_few_unique`
+ *
+ *   Fills an array with random values from a set of 16.
+ */
+static void fill_few_unique(int * const arr, const size_t len) {
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    arr[i] = rand() % 16;
+  }
+}
+
+/**
+ * `fill_wide`
+ *
+ *   Fills an array with random values from the whole range of integers.
+ */
+static void fill_wide(int * const arr, const size_t len) {
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    arr[i] = (int)(((unsigned int)rand() << 16) ^ (unsigned int)rand());
+  }
+}
+
+/**
+ * `fill_keys`
+ *
+ *   Fills an array with random 64-bit keys.
+ *
+ * @param keys
+ *   The array to be filled.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param dense
+ *   Non-zero to use keys less than the length, with duplicates, instead of
+ *   keys from the whole 64-bit range.
+ */
+static void fill_keys(unsigned long long * const keys, const size_t len,
+  const int dense) {
+  size_t i;
+
+  for(i = 0; i < len; i++) {
+    keys[i] = ((unsigned long long)rand() << 42)
+      ^ ((unsigned long long)rand() << 21) ^ (unsigned long long)rand();
+    if(dense) {
+      keys[i] %= len;
+    }
+  }
+}
+
+/**
+ * `time_best`
+ *
+ *   Lays out fresh copies and sorts them `BENCH_REPS` times, and records the
+ *   best time. If a sort fails, the remaining runs only wait on the barrier,
+ *   so the other threads are not left waiting.
+ *
+ * @param tm
+ *   The benchmark.
+ *
+ * @return
+ *   The best time to sort all of the copies, in nanoseconds, or -1 if the
+ *   benchmark was skipped or a sort failed.
+ */
+static double time_best(timing * const tm) {
+  struct timespec start, end;
+  double ns, best = -1;
+  size_t c;
+  int r;
+
+  for(r = 0; r < BENCH_REPS; r++) {
+
+    /*** Lay out fresh copies of the input. ***/
+    for(c = 0; !tm->skipped && c < tm->copies; c++) {
+      tm->lay_out(tm, c);
+    }
+
+    /*** Start all of the threads together. ***/
+    if(tm->barrier != NULL) {
+      pthread_barrier_wait(tm->barrier);
+    }
+    if(tm->skipped) {
+      continue;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(c = 0; !tm->skipped && c < tm->copies; c++) {
+      tm->skipped = tm->sort(tm, c) != 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    if(best < 0 || ns < best) {
+      best = ns;
+    }
+  }
+  return tm->skipped ? -1 : best;
+}
+
+/**
+ * `lay_out_worker`
+ *
+ *   Copies the input of a worker.
+ */
+static void lay_out_worker(timing * const tm, const size_t c) {
+  worker * const w = (worker *)tm;
+
+  memcpy(w->buf + c * w->n, w->input, sizeof(int) * w->n);
+}
+
+/**
+ * `sort_worker`
+ *
+ *   Sorts a copy of the input of a worker and records the algorithm
+ *   `sort_auto` selected, if it was used.
+ */
+static int sort_worker(timing * const tm, const size_t c) {
+  worker * const w = (worker *)tm;
+
+  w->algo->sort(w->buf + c * w->n, w->n);
+  w->choice = auto_choice;
+  return 0;
+}
+
+/**
+ * `fill_offsets`
+ *
+ *   Divides an array into segments of random lengths. Most are up to
+ *   `SEGMENT_SMALL` elements long, and one in `SEGMENT_SMALL` up to
+ *   `SEGMENT_LARGE`.
+ *
+ * @param offsets
+ *   Filled in with the offsets of the segments, with room for `len + 1`.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @return
+ *   The number of segments.
+ */
+static size_t fill_offsets(size_t * const offsets, const size_t len) {
+  size_t segs = 0, seg;
+
+  offsets[0] = 0;
+  while(offsets[segs] < len) {
+    seg = 1 + (size_t)rand()
+      % (rand() % SEGMENT_SMALL ? SEGMENT_SMALL : SEGMENT_LARGE);
+    seg = seg < len - offsets[segs] ? seg : len - offsets[segs];
+    offsets[segs + 1] = offsets[segs] + seg;
+    segs++;
+  }
+  return segs;
+}
+
+/**
+ * `run_worker`
+ *
+ *   Sorts copies of the input repeatedly and records the best time.
+ *
+ * @param arg
+ *   The worker.
+ *
+ * @return
+ *   NULL.
+ */
+static void *run_worker(void *arg) {
+  worker * const w = (worker *)arg;
+
+  w->buf = (int *)malloc(sizeof(int) * w->n * w->tm.copies);
+  w->choice = auto_choice = -1;
+  w->tm.skipped = w->buf == NULL;
+  w->failed = 0;
+  w->best_ns = time_best(&w->tm);
+
+  /*** Make sure the last copy was sorted. ***/
+  /*** The workers already run one per thread, so each checks alone. ***/
+  if(!w->tm.skipped && test_arr_threads(w->buf + (w->tm.copies - 1) * w->n,
+    w->n, w->fp, 1) != TEST_OK) {
+    w->failed = 1;
+  }
+
+  free(w->buf);
+  return NULL;
+}
+
+/**
+ * `run`
+ *
+ *   Benchmarks one algorithm on one input with a number of threads.
+ *
+ * @param algo
+ *   The algorithm.
+ *
+ * @param input
+ *   The input array.
+ *
+ * @param fp
+ *   The fingerprint of the input array.
+ *
+ * @param n
+ *   The length of the input array.
+ *
+ * @param threads
+ *   The number of threads.
+ *
+ * @param res
+ *   Filled in with the result.
+ *
+ * @return
+ *   0 on success, 1 if the benchmark was skipped for lack of memory, or -1 if
+ *   it failed.
+ */
+static int run(const algorithm * const algo, const int * const input,
+  const sort_fingerprint * const fp, const size_t n, const size_t threads,
+  result * const res) {
+  const size_t copies = n < BENCH_MIN_ELEMS ? BENCH_MIN_ELEMS / n : 1;
+  pthread_t tids[MAX_THREADS];
+  worker workers[MAX_THREADS];
+  pthread_barrier_t barrier;
+  size_t t, started;
+  double worst = 0;
+  int skipped = 0, failed = 0;
+
+  /*** The input, and each thread's copies and scratch memory. ***/
+  if(!fits(sizeof(int) * (n + (n * copies + (n >> 1) * algo->scratch)
+    * threads))) {
+    return 1;
+  }
+
+  pthread_barrier_init(&barrier, NULL, (unsigned int)threads);
+  for(t = 0; t < threads; t++) {
+    workers[t].tm.lay_out = lay_out_worker;
+    workers[t].tm.sort = sort_worker;
+    workers[t].tm.copies = copies;
+    workers[t].tm.barrier = &barrier;
+    workers[t].algo = algo;
+    workers[t].input = input;
+    workers[t].fp = fp;
+    workers[t].n = n;
+  }
+
+  /*** Run the first worker on this thread once the others have started. ***/
+  for(started = 1; started < threads; started++) {
+    if(pthread_create(&tids[started], NULL, run_worker, &workers[started])
+      != 0) {
+      break;
+    }
+  }
+  if(started < threads) {
+    /*** The barrier could never be reached by all of the threads. ***/
+    printf("error: failed to create %lu threads.\n", (unsigned long)threads);
+    exit(2);
+  }
+  run_worker(&workers[0]);
+  for(t = 1; t < threads; t++) {
+    pthread_join(tids[t], NULL);
+  }
+  pthread_barrier_destroy(&barrier);
+
+  /*** The slowest thread bounds the throughput of all of them. ***/
+  for(t = 0; t < threads; t++) {
+    skipped |= workers[t].tm.skipped;
+    failed |= workers[t].failed;
+    if(workers[t].best_ns > worst) {
+      worst = workers[t].best_ns;
+    }
+  }
+  if(skipped) {
+    return 1;
+  }
+  if(failed || worst <= 0) {
+    return -1;
+  }
+
+  res->n = n;
+  strncpy(res->algo, algo->name, NAME_LEN - 1);
+  res->algo[NAME_LEN - 1] = '\0';
+  res->threads = threads;
+  res->ns_per_elem = workers[0].best_ns / (double)(n * copies);
+  res->melem_per_s = (double)(threads * n * copies) / worst * 1e3;
+  strncpy(res->choice, workers[0].choice < 0 ? "-"
+    : sort_algo_name((sort_algo)workers[0].choice), NAME_LEN - 1);
+  res->choice[NAME_LEN - 1] = '\0';
+  return 0;
+}
+
+/**
+ * `lay_out_kv`
+ *
+ *   Lays out a copy of the keys with their row ids as the values.
+ */
+static void lay_out_kv(timing * const tm, const size_t c) {
+  kv_bench * const kv = (kv_bench *)tm;
+  const size_t n = kv->n;
+  size_t i;
+
+  for(i = 0; i < n; i++) {
+    if(kv->layout == KV_SOA_RADIX) {
+      kv->ks[c * n + i] = kv->keys[i];
+      kv->vs[c * n + i] = i;
+    }
+    else {
+      kv->pairs[c * n + i].key = kv->keys[i];
+      kv->pairs[c * n + i].val = i;
+    }
+  }
+}
+
+/**
+ * `sort_kv_copy`
+ *
+ *   Sorts a copy of the pairs. The sorts only fail to allocate their scratch
+ *   memory.
+ */
+static int sort_kv_copy(timing * const tm, const size_t c) {
+  kv_bench * const kv = (kv_bench *)tm;
+  const size_t n = kv->n;
+
+  switch(kv->layout) {
+    case KV_AOS_MERGE:
+      return merge_sort_kv(kv->pairs + c * n, n, &kv->ctx);
+    case KV_AOS_RADIX:
+      return radix_lsd_sort_kv(kv->pairs + c * n, n, &kv->ctx);
+    case KV_SOA_RADIX:
+      return radix_lsd_sort_kv_soa(kv->ks + c * n, kv->vs + c * n, n,
+        &kv->ctx);
+  }
+  return -1;
+}
+
+/**
+ * `run_kv`
+ *
+ *   Benchmarks stably sorting key-value pairs in one layout on one thread.
+ *   The values are the original positions of the keys, so each pair can be
+ *   checked against the input, and the order of equal keys shows whether the
+ *   sort was stable.
+ *
+ * @param layout
+ *   The layout and algorithm.
+ *
+ * @param dist
+ *   The index of the key distribution in `KV_DISTRIBUTIONS`.
+ *
+ * @param n
+ *   The number of pairs.
+ *
+ * @param res
+ *   Filled in with the result.
+ *
+ * @return
+ *   0 on success, 1 if the benchmark was skipped for lack of memory, or -1 if
+ *   it failed.
+ */
+static int run_kv(const kv_layout layout, const int dist, const size_t n,
+  result * const res) {
+  const size_t copies = n < BENCH_MIN_ELEMS ? BENCH_MIN_ELEMS / n : 1;
+  unsigned long long *keys = NULL, k0 = 0, k1, v0 = 0, v1;
+  unsigned char *seen = NULL;
+  kv_bench kv;
+  double best = -1;
+  size_t i, last;
+  int failed = 0;
+
+  memset(&kv, 0, sizeof(kv));
+  kv.tm.lay_out = lay_out_kv;
+  kv.tm.sort = sort_kv_copy;
+  kv.tm.copies = copies;
+  kv.layout = layout;
+  kv.n = n;
+  sort_ctx_init(&kv.ctx, 0, 0);
+
+  /*** The input keys, the copies, the sort's scratch, and the check. ***/
+  if(fits(sizeof(unsigned long long) * n * (4 * copies + 2))) {
+    keys = (unsigned long long *)malloc(sizeof(*keys) * n);
+    seen = (unsigned char *)calloc(n, 1);
+    if(layout == KV_SOA_RADIX) {
+      kv.ks = (unsigned long long *)malloc(sizeof(*kv.ks) * n * copies);
+      kv.vs = (unsigned long long *)malloc(sizeof(*kv.vs) * n * copies);
+    }
+    else {
+      kv.pairs = (sort_kv *)malloc(sizeof(*kv.pairs) * n * copies);
+    }
+  }
+  kv.tm.skipped = keys == NULL || seen == NULL
+    || (layout == KV_SOA_RADIX ? kv.ks == NULL || kv.vs == NULL
+      : kv.pairs == NULL);
+
+  if(!kv.tm.skipped) {
+    srand(1);
+    fill_keys(keys, n, dist);
+    kv.keys = keys;
+    best = time_best(&kv.tm);
+  }
+
+  /*** Make sure the last copy is in order, stable, and that each pair is ***/
+  /*** a row of the input, with every row present once.                  ***/
+  last = (copies - 1) * n;
+  for(i = 0; !kv.tm.skipped && !failed && i < n; i++) {
+    k1 = layout == KV_SOA_RADIX ? kv.ks[last + i] : kv.pairs[last + i].key;
+    v1 = layout == KV_SOA_RADIX ? kv.vs[last + i] : kv.pairs[last + i].val;
+    if(v1 >= n || seen[v1] || keys[v1] != k1
+      || (i > 0 && (k0 > k1 || (k0 == k1 && v0 > v1)))) {
+      failed = 1;
+      break;
+    }
+    seen[v1] = 1;
+    k0 = k1;
+    v0 = v1;
+  }
+
+  sort_ctx_free(&kv.ctx);
+  free(keys);
+  free(seen);
+  free(kv.pairs);
+  free(kv.ks);
+  free(kv.vs);
+  if(kv.tm.skipped) {
+    return 1;
+  }
+  if(failed || best <= 0) {
+    return -1;
+  }
+
+  res->n = n;
+  strncpy(res->dist, KV_DISTRIBUTIONS[dist], NAME_LEN - 1);
+  res->dist[NAME_LEN - 1] = '\0';
+  strncpy(res->algo, KV_NAMES[layout], NAME_LEN - 1);
+  res->algo[NAME_LEN - 1] = '\0';
+  res->threads = 1;
+  res->ns_per_elem = best / (double)(n * copies);
+  res->melem_per_s = (double)(n * copies) / best * 1e3;
+  strcpy(res->choice, "-");
+  return 0;
+}
+
+/**
+ * `lay_out_numa`
+ *
+ *   Copies the input of the NUMA-aware parallel sort.
+ */
+static void lay_out_numa(timing * const tm, const size_t c) {
+  numa_bench * const nb = (numa_bench *)tm;
+
+  memcpy(nb->arr + c * nb->n, nb->input, sizeof(int) * nb->n);
+}
+
+/**
+ * `sort_numa`
+ *
+ *   Sorts a copy of the input with the NUMA-aware parallel sort.
+ */
+static int sort_numa(timing * const tm, const size_t c) {
+  numa_bench * const nb = (numa_bench *)tm;
+
+  numa_sort_ctx(nb->arr + c * nb->n, nb->n, nb->ctxs, nb->threads,
+    nb->place->nodes, nb->place->flags);
+  return 0;
+}
+
+/**
+ * `run_numa`
+ *
+ *   Benchmarks the NUMA-aware parallel sort on the random input, with every
+ *   thread sorting the same array.
+ *
+ * @param place
+ *   The placement of the threads.
+ *
+ * @param input
+ *   The random input.
+ *
+ * @param fp
+ *   The fingerprint of the input.
+ *
+ * @param n
+ *   The length of the input.
+ *
+ * @param threads
+ *   The number of threads.
+ *
+ * @param res
+ *   Filled in with the result.
+ *
+ * @return
+ *   0 on success, 1 if the benchmark was skipped for lack of memory, or -1 if
+ *   it failed.
+ */
+static int run_numa(const placement * const place, const int * const input,
+  const sort_fingerprint * const fp, const size_t n, const size_t threads,
+  result * const res) {
+  const size_t copies = n < BENCH_MIN_ELEMS ? BENCH_MIN_ELEMS / n : 1;
+  const size_t chunk = n - n / threads * (threads - 1);
+  numa_bench nb;
+  double best;
+  size_t c, t;
+  int failed = 0;
+
+  nb.tm.lay_out = lay_out_numa;
+  nb.tm.sort = sort_numa;
+  nb.tm.copies = copies;
+  nb.tm.barrier = NULL;
+  nb.tm.skipped = 0;
+  nb.place = place;
+  nb.input = input;
+  nb.n = n;
+  nb.threads = threads;
+
+  /*** The input, the copies, and twice each chunk in its context. ***/
+  nb.arr = fits(sizeof(int) * (n + n * copies + chunk * threads * 2))
+    ? (int *)malloc(sizeof(int) * n * copies) : NULL;
+  if(nb.arr == NULL) {
+    return 1;
+  }
+
+  /*** The baseline's scratch memory is allocated and first touched here, ***/
+  /*** as a NUMA-oblivious caller would. Otherwise, each thread touches    ***/
+  /*** its context first and reuses it in later runs.                     ***/
+  for(t = 0; t < threads; t++) {
+    sort_ctx_init(&nb.ctxs[t], 0, 0);
+    if(place->flags & NUMA_SORT_IN_PLACE) {
+      if(sort_ctx_scratch(&nb.ctxs[t], sizeof(int) * chunk * 2) == NULL) {
+        nb.tm.skipped = 1;
+        break;
+      }
+      memset(nb.ctxs[t].arena, 0, nb.ctxs[t].arena_len);
+    }
+  }
+  for(; t < threads; t++) {
+    sort_ctx_init(&nb.ctxs[t], 0, 0);
+  }
+  best = time_best(&nb.tm);
+
+  for(c = 0; !nb.tm.skipped && c < copies && !failed; c++) {
+    failed = test_arr(nb.arr + c * n, n, fp) != TEST_OK;
+  }
+  for(t = 0; t < threads; t++) {
+    sort_ctx_free(&nb.ctxs[t]);
+  }
+  free(nb.arr);
+  if(nb.tm.skipped) {
+    return 1;
+  }
+  if(failed || best <= 0) {
+    return -1;
+  }
+
+  res->n = n;
+  strncpy(res->dist, DISTRIBUTIONS[DIST_RANDOM].name, NAME_LEN - 1);
+  res->dist[NAME_LEN - 1] = '\0';
+  strncpy(res->algo, place->name, NAME_LEN - 1);
+  res->algo[NAME_LEN - 1] = '\0';
+  res->threads = threads;
+  res->ns_per_elem = best / (double)(n * copies);
+  res->melem_per_s = (double)(n * copies) / best * 1e3;
+  strcpy(res->choice, "-");
+  return 0;
+}
+
+/**
+ * `lay_out_segments`
+ *
+ *   Copies the input of the segmented sort.
+ */
+static void lay_out_segments(timing * const tm, const size_t c) {
+  segment_bench * const sb = (segment_bench *)tm;
+
+  memcpy(sb->arr + c * sb->n, sb->input, sizeof(int) * sb->n);
+}
+
+/**
+ * `sort_segments`
+ *
+ *   Sorts the segments of a copy of the input.
+ */
+static int sort_segments(timing * const tm, const size_t c) {
+  segment_bench * const sb = (segment_bench *)tm;
+
+  segmented_sort_ctx(sb->arr + c * sb->n, sb->offsets, sb->segs, sb->ctxs,
+    sb->threads);
+  return 0;
+}
+
+/**
+ * `run_segments`
+ *
+ *   Benchmarks segmented sort on the random input divided into segments of
+ *   random lengths, with the threads sharing the segments of each copy.
+ *
+ * @param input
+ *   The random input.
+ *
+ * @param fp
+ *   The fingerprint of the input.
+ *
+ * @param n
+ *   The length of the input.
+ *
+ * @param threads
+ *   The number of threads.
+ *
+ * @param res
+ *   Filled in with the result.
+ *
+ * @return
+ *   0 on success, 1 if the benchmark was skipped for lack of memory, or -1 if
+ *   it failed.
+ */
+static int run_segments(const int * const input,
+  const sort_fingerprint * const fp, const size_t n, const size_t threads,
+  result * const res) {
+  const size_t copies = n < BENCH_MIN_ELEMS ? BENCH_MIN_ELEMS / n : 1;
+  size_t *offsets = NULL;
+  segment_bench sb;
+  sort_fingerprint after;
+  double best = -1;
+  size_t s, t;
+  int *last;
+  int failed = 0;
+
+  sb.tm.lay_out = lay_out_segments;
+  sb.tm.sort = sort_segments;
+  sb.tm.copies = copies;
+  sb.tm.barrier = NULL;
+  sb.input = input;
+  sb.n = n;
+  sb.threads = threads;
+  sb.arr = NULL;
+  for(t = 0; t < threads; t++) {
+    sort_ctx_init(&sb.ctxs[t], 0, 0);
+  }
+
+  /*** The input, the copies, the offsets, and the radix sort's scratch ***/
+  /*** memory.                                                         ***/
+  if(fits(sizeof(int) * n * (copies + 2) + sizeof(size_t) * (n + 1))) {
+    sb.arr = (int *)malloc(sizeof(int) * n * copies);
+    offsets = (size_t *)malloc(sizeof(size_t) * (n + 1));
+  }
+  sb.tm.skipped = sb.arr == NULL || offsets == NULL;
+  if(!sb.tm.skipped) {
+    srand(1);
+    sb.segs = fill_offsets(offsets, n);
+    sb.offsets = offsets;
+    best = time_best(&sb.tm);
+  }
+
+  /*** Make sure each segment of the last copy was sorted, and that the ***/
+  /*** copy kept every element.                                         ***/
+  last = sb.tm.skipped ? NULL : sb.arr + (copies - 1) * n;
+  for(s = 0; !sb.tm.skipped && !failed && s < sb.segs; s++) {
+    failed = test_arr(last + offsets[s], offsets[s + 1] - offsets[s], NULL)
+      != TEST_OK;
+  }
+  if(!sb.tm.skipped && !failed) {
+    fingerprint_arr(last, n, &after);
+    failed = after.sum != fp->sum || after.mix_sum != fp->mix_sum
+      || after.mix_xor != fp->mix_xor;
+  }
+
+  for(t = 0; t < threads; t++) {
+    sort_ctx_free(&sb.ctxs[t]);
+  }
+  free(sb.arr);
+  free(offsets);
+  if(sb.tm.skipped) {
+    return 1;
+  }
+  if(failed || best <= 0) {
+    return -1;
+  }
+
+  res->n = n;
+  strncpy(res->dist, DISTRIBUTIONS[DIST_RANDOM].name, NAME_LEN - 1);
+  res->dist[NAME_LEN - 1] = '\0';
+  strncpy(res->algo, "segmented_sort", NAME_LEN - 1);
+  res->algo[NAME_LEN - 1] = '\0';
+  res->threads = threads;
+  res->ns_per_elem = best / (double)(n * copies);
+  res->melem_per_s = (double)(n * copies) / best * 1e3;
+  strcpy(res->choice, "-");
+  return 0;
+}
+
+/**
+ * `lay_out_batch`
+ *
+ *   Copies the sorted array and the batch.
+ */
+static void lay_out_batch(timing * const tm, const size_t c) {
+  batch_bench * const bb = (batch_bench *)tm;
+
+  memcpy(bb->arr + c * (bb->n + bb->b), bb->sorted, sizeof(int) * bb->n);
+  memcpy(bb->batches + c * bb->b, bb->batch, sizeof(int) * bb->b);
+}
+
+/**
+ * `sort_batch`
+ *
+ *   Inserts a copy of the batch into a copy of the sorted array.
+ */
+static int sort_batch(timing * const tm, const size_t c) {
+  batch_bench * const bb = (batch_bench *)tm;
+
+  batch_insert(bb->arr + c * (bb->n + bb->b), bb->n, bb->batches + c * bb->b,
+    bb->b);
+  return 0;
+}
+
+/**
+ * `run_batch`
+ *
+ *   Benchmarks inserting a batch of random elements, `BATCH_DIV` times
+ *   shorter than the input, into the random input once it is sorted.
+ *
+ * @param input
+ *   The random input.
+ *
+ * @param n
+ *   The length of the input.
+ *
+ * @param res
+ *   Filled in with the result.
+ *
+ * @return
+ *   0 on success, 1 if the benchmark was skipped for lack of memory, or -1 if
+ *   it failed.
+ */
+static int run_batch(const int * const input, const size_t n,
+  result * const res) {
+  const size_t b = n / BATCH_DIV + 1;
+  const size_t copies = n < BENCH_MIN_ELEMS ? BENCH_MIN_ELEMS / n : 1;
+  int *sorted = NULL, *batch = NULL;
+  sort_fingerprint before;
+  batch_bench bb;
+  double best = -1;
+  size_t i;
+  int failed = 0;
+
+  bb.tm.lay_out = lay_out_batch;
+  bb.tm.sort = sort_batch;
+  bb.tm.copies = copies;
+  bb.tm.barrier = NULL;
+  bb.n = n;
+  bb.b = b;
+  bb.arr = bb.batches = NULL;
+
+  /*** The input, the sorted array, the batch, and their copies. ***/
+  if(fits(sizeof(int) * (n + (n + b) * (copies + 2)))) {
+    sorted = (int *)malloc(sizeof(int) * (n + b));
+    batch = (int *)malloc(sizeof(int) * b);
+    bb.arr = (int *)malloc(sizeof(int) * (n + b) * copies);
+    bb.batches = (int *)malloc(sizeof(int) * b * copies);
+  }
+  bb.tm.skipped = sorted == NULL || batch == NULL || bb.arr == NULL
+    || bb.batches == NULL;
+
+  if(!bb.tm.skipped) {
+
+    /*** Sort the input, and fingerprint it together with the batch. ***/
+    memcpy(sorted, input, sizeof(int) * n);
+    radix_lsd_sort(sorted, n);
+    srand(1);
+    for(i = 0; i < b; i++) {
+      batch[i] = sorted[n + i] = rand() % (int)n;
+    }
+    fingerprint_arr(sorted, n + b, &before);
+
+    bb.sorted = sorted;
+    bb.batch = batch;
+    best = time_best(&bb.tm);
+  }
+
+  /*** Make sure the last copy is sorted and kept every element of the ***/
+  /*** array and the batch.                                             ***/
+  if(!bb.tm.skipped) {
+    failed = test_arr(bb.arr + (copies - 1) * (n + b), n + b, &before)
+      != TEST_OK;
+  }
+
+  free(sorted);
+  free(batch);
+  free(bb.arr);
+  free(bb.batches);
+  if(bb.tm.skipped) {
+    return 1;
+  }
+  if(failed || best <= 0) {
+    return -1;
+  }
+
+  res->n = n;
+  strncpy(res->dist, DISTRIBUTIONS[DIST_RANDOM].name, NAME_LEN - 1);
+  res->dist[NAME_LEN - 1] = '\0';
+  strncpy(res->algo, "batch_insert", NAME_LEN - 1);
+  res->algo[NAME_LEN - 1] = '\0';
+  res->threads = 1;
+  res->ns_per_elem = best / (double)((n + b) * copies);
+  res->melem_per_s = (double)((n + b) * copies) / best * 1e3;
+  strcpy(res->choice, "-");
+  return 0;
+}
+
+/**
+ * `next_result`
+ *
+ *   Gets room for the next result, growing the results if needed. Exits if
+ *   the results cannot be grown.
+ *
+ * @param results
+ *   The results.
+ *
+ * @param nresults
+ *   The number of results so far.
+ *
+ * @param cap
+ *   The number of results there is room for.
+ *
+ * @return
+ *   The room for the next result.
+ */
+static result *next_result(result ** const results, const size_t nresults,
+  size_t * const cap) {
+  if(nresults == *cap) {
+    *cap = *cap ? *cap << 1 : 256;
+    *results = (result *)realloc(*results, sizeof(result) * *cap);
+    if(*results == NULL) {
+      printf("error: failed to allocate the results.\n");
+      exit(2);
+    }
+  }
+  return &(*results)[nresults];
+}
+
+/**
+ * `write_result`
+ *
+ *   Writes a result to the results file and prints it.
+ *
+ * @param out
+ *   The results file.
+ *
+ * @param res
+ *   The result.
+ */
+static void write_result(FILE * const out, const result * const res) {
+  fprintf(out, "%lu,%s,%s,%lu,%.4f,%.4f,%s\n", (unsigned long)res->n,
+    res->dist, res->algo, (unsigned long)res->threads, res->ns_per_elem,
+    res->melem_per_s, res->choice);
+  printf("n=%-10lu %-10s %-21s threads=%-3lu %10.3f ns/elem %10.2f Melem/s"
+    " %s\n", (unsigned long)res->n, res->dist, res->algo,
+    (unsigned long)res->threads, res->ns_per_elem, res->melem_per_s,
+    strcmp(res->choice, "-") ? res->choice : "");
+  fflush(stdout);
+}
+
+/**
+ * `load_results`
+ *
+ *   Loads results from a CSV file written by this program.
+ *
+ * @param path
+ *   The path of the file.
+ *
+ * @param results
+ *   Set to the loaded results, to be freed by the caller.
+ *
+ * @return
+ *   The number of results loaded.
+ */
+static size_t load_results(const char * const path, result ** const results) {
+  FILE *in = fopen(path, "r");
+  size_t count = 0, cap = 0;
+  unsigned long n, threads;
+  result res;
+  char line[256];
+
+  *results = NULL;
+  if(in == NULL) {
+    return 0;
+  }
+
+  while(fgets(line, sizeof(line), in) != NULL) {
+    if(sscanf(line, "%lu,%31[^,],%31[^,],%lu,%lf,%lf", &n, res.dist,
+      res.algo, &threads, &res.ns_per_elem, &res.melem_per_s) != 6) {
+      continue;
+    }
+    res.n = n;
+    res.threads = threads;
+    strcpy(res.choice, "-");
+    if(count == cap) {
+      cap = cap ? cap << 1 : 256;
+      *results = (result *)realloc(*results, sizeof(result) * cap);
+      if(*results == NULL) {
+        fclose(in);
+        return 0;
+      }
+    }
+    (*results)[count++] = res;
+  }
+
+  fclose(in);
+  return count;
+}
+
+/**
+ * `same_case`
+ *
+ *   Checks whether two results measure the same case.
+ *
+ * @param a
+ *   A result.
+ *
+ * @param b
+ *   Another result.
+ *
+ * @return
+ *   Non-zero if the length, distribution, algorithm, and thread count match.
+ */
+static int same_case(const result * const a, const result * const b) {
+  return a->n == b->n && a->threads == b->threads
+    && !strcmp(a->dist, b->dist) && !strcmp(a->algo, b->algo);
+}
+
+/**
+ * `compare`
+ *
+ *   Compares results to a baseline and prints each regression. Baseline
+ *   results with no match in the new results, such as cases skipped for
+ *   memory or removed from the sweep, are printed and count as failures, since
+ *   a regression in them would otherwise go unnoticed.
+ *
+ * @param results
+ *   The new results.
+ *
+ * @param nresults
+ *   The number of new results.
+ *
+ * @param baseline
+ *   The baseline results.
+ *
+ * @param nbaseline
+ *   The number of baseline results.
+ *
+ * @param regress_pct
+ *   The drop in throughput, in percent, that counts as a regression.
+ *
+ * @return
+ *   The number of regressions plus the number of missing baseline results.
+ */
+static int compare(const result * const results, const size_t nresults,
+  const result * const baseline, const size_t nbaseline,
+  const double regress_pct) {
+  size_t i, j, matched = 0, missing = 0;
+  double change;
+  int regressions = 0;
+
+  for(i = 0; i < nresults; i++) {
+    for(j = 0; j < nbaseline; j++) {
+      if(same_case(&results[i], &baseline[j])) {
+        break;
+      }
+    }
+    if(j == nbaseline) {
+      continue;
+    }
+    matched++;
+
+    change = (results[i].melem_per_s / baseline[j].melem_per_s - 1) * 100;
+    if(change < -regress_pct) {
+      printf("REGRESSION n=%lu %s %s threads=%lu: %.2f -> %.2f Melem/s"
+        " (%.1f%%)\n", (unsigned long)results[i].n, results[i].dist,
+        results[i].algo, (unsigned long)results[i].threads,
+        baseline[j].melem_per_s, results[i].melem_per_s, change);
+      regressions++;
+    }
+  }
+
+  /*** Baseline results missing from this run were not checked at all. ***/
+  for(j = 0; j < nbaseline; j++) {
+    for(i = 0; i < nresults; i++) {
+      if(same_case(&results[i], &baseline[j])) {
+        break;
+      }
+    }
+    if(i == nresults) {
+      printf("MISSING n=%lu %s %s threads=%lu: in the baseline but not in this"
+        " run\n", (unsigned long)baseline[j].n, baseline[j].dist,
+        baseline[j].algo, (unsigned long)baseline[j].threads);
+      missing++;
+    }
+  }
+
+  printf("compared %lu results to the baseline: %d regressed by more than"
+    " %.1f%%, %lu baseline results are missing, and %lu new results have no"
+    " baseline.\n", (unsigned long)matched, regressions, regress_pct,
+    (unsigned long)missing, (unsigned long)(nresults - matched));
+  if(missing > 0) {
+    printf("record a new baseline with `make bench-baseline` if the missing"
+      " cases were removed on purpose.\n");
+  }
+  return regressions + (int)missing;
+}
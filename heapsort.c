@@ -2,7 +2,7 @@
   File: heapsort.c
   Author: CJ Dimaano
   Date created: March 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   Heapsort is a comparison-based sorting algorithm. It uses the idea of a
   complete binary tree in order to organize a collection of elements into a
@@ -66,11 +66,12 @@ void heapsort(int * const arr, const size_t len) {
     for(i = 1; i < end; i++) {
       val = arr[i];
       j = i;
-      while(j > 0 && val > arr[(k = PI(j))]) {
+      while(j > 0 && LESS(arr[(k = PI(j))], val)) {
         swap(arr, j, k);
         j = k;
       }
       arr[j] = val;
+      MOVED(1);
     }
 
     /*** Swap the root of the heap with the end of the heap. ***/
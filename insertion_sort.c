@@ -2,7 +2,7 @@
   File: insertion_sort.c
   Author: CJ Dimaano
   Date created: March 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   Insertion sort is a comparison-based sorting algorithm. It works by visiting
   each element in the array and inserting the current element into the sorted
@@ -38,13 +38,15 @@ void insertion_sort(int * const arr, const size_t len) {
     /*** Shift all of the elements in the sorted portion of the array that ***/
     /*** are not better than the value of the current element.             ***/
     j = i;
-    while(j < len && val < arr[j - 1]) {
+    while(j > 0 && LESS(val, arr[j - 1])) {
       arr[j] = arr[j - 1];
+      MOVED(1);
       j--;
     }
 
     /*** Insert the value of the current element into the sorted portion of ***/
     /*** the array.                                                         ***/
     arr[j] = val;
+    MOVED(1);
   }
 }
@@ -2,28 +2,71 @@
   File: main.c
   Author: CJ Dimaano
   Date created: March 4, 2016
-  Last updated: March 6, 2016
+  Last updated: October 19, 2026
 *******************************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
+#include "perf_counters.h"
 #include "sort.h"
 
 #define DEF_N 32
 #define MAX_N (RAND_MAX > ~(1 << 31) ? ~(1 << 31) : RAND_MAX)
+#define PRINT_MAX_N DEF_N
+#define QUADRATIC_MAX_N (1 << 16)
+
+/* Types **********************************************************************/
+
+/**
+ * `algorithm`
+ *
+ *   A sorting algorithm to be benchmarked.
+ */
+typedef struct {
+  const char *name;
+  void (*sort)(int * const, const size_t);
+  int quadratic;  /* Whether the algorithm is too slow for large arrays. */
+} algorithm;
 
 /* Function declarations ******************************************************/
 
 static void print_usage(const char * const);
 static void print_arr(const int * const, const int);
+static void print_profile(const sort_profile * const);
+static void auto_sort(int * const, const size_t);
+static void parallel_sort(int * const, const size_t);
+static int benchmark(const int * const, int * const, const int,
+  const sort_fingerprint * const);
+static int report_test(const int);
+
+/* Algorithms *****************************************************************/
+
+static const algorithm ALGORITHMS[] = {
+  { "selection_sort", selection_sort, 1 },
+  { "insertion_sort", insertion_sort, 1 },
+  { "merge_sort",     merge_sort,     0 },
+  { "quicksort",      quicksort,      0 },
+  { "quicksort_3way", quicksort_3way, 0 },
+  { "heapsort",       heapsort,       1 },
+  { "radix_lsd_sort", radix_lsd_sort, 0 },
+  { "sort_auto",      auto_sort,      0 },
+  { "numa_sort",      parallel_sort,  0 }
+};
 
 /* Main ***********************************************************************/
 
 int main(int argc, char **argv) {
   int n = DEF_N;    /* Number of elements to be sorted. */
   int *arr = NULL;  /* Array to be sorted. */
+  int *orig = NULL; /* Unsorted copy of the array. */
+  sort_fingerprint fp;  /* Fingerprint of the unsorted array. */
+  int status = 0;   /* Exit status. */
+  sort_profile prof;  /* Profile recorded by sort_auto. */
+  sort_ctx ctx;       /* Scratch memory for sorting. */
 
   /*** Check if any arguments were provided. ***/
   if(argc > 1) {
@@ -45,27 +88,45 @@ int main(int argc, char **argv) {
 
   /*** Try to initialize the array. ***/
   arr = (int *)malloc(sizeof(int) * n);
-  if(arr == NULL) {
+  orig = (int *)malloc(sizeof(int) * n);
+  if(arr == NULL || orig == NULL) {
     printf("error: failed to allocate the array.\n");
+    free(arr);
+    free(orig);
     return 0;
   }
-  init_arr(arr, n);
-  print_arr(arr, n);
+  init_arr(orig, n);
+  fingerprint_arr(orig, n, &fp);
+  memcpy(arr, orig, sizeof(int) * n);
+  if(n <= PRINT_MAX_N) {
+    print_arr(arr, n);
+  }
+  sort_ctx_init(&ctx, 0, SORT_CTX_HUGE_PAGES);
 
   /*** Sort the array. ***/
   /*heapsort(arr, n);*/
   /*selection_sort(arr, n);*/
   /*insertion_sort(arr, n);*/
   /*merge_sort(arr, n);*/
-  quicksort(arr, n);
+  /*quicksort(arr, n);*/
+  /*quicksort_3way(arr, n);*/
   /*radix_lsd_sort(arr, n);*/
-  test_arr(arr, n);
-  print_arr(arr, n);
+  sort_auto_ctx(arr, n, &ctx, &prof);
+  status |= report_test(test_arr(arr, n, &fp));
+  if(n <= PRINT_MAX_N) {
+    print_arr(arr, n);
+  }
+  print_profile(&prof);
+
+  /*** Benchmark each algorithm on the same unsorted array. ***/
+  status |= benchmark(orig, arr, n, &fp);
 
   /*** Free the allocated array. ***/
+  sort_ctx_free(&ctx);
+  free(orig);
   free(arr);
   
-  return 0;
+  return status;
 }
 
 /* Function definitions *******************************************************/
@@ -106,3 +167,163 @@ static void print_arr(const int * const arr, const int len) {
   }
   printf(" ]\n");
 }
+
+/**
+ * `print_profile`
+ *
+ *   Prints the profile recorded by `sort_auto`, the algorithm it selected, and
+ *   the thresholds it used.
+ *
+ * @param prof
+ *   The profile to be printed.
+ */
+static void print_profile(const sort_profile * const prof) {
+  printf("sort_auto: n=%lu runs=%lu reverse_runs=%lu range=[%d, %d]"
+    " unique=%lu/%lu -> %s\n", (unsigned long)prof->len,
+    (unsigned long)prof->runs, (unsigned long)prof->reverse_runs, prof->min,
+    prof->max, (unsigned long)prof->sample_unique,
+    (unsigned long)prof->sample_len, sort_algo_name(prof->algo));
+  printf("\tinsertion_max=%d presorted_div=%d few_unique_pct=%d radix_min=%d"
+    " dense_min=%d sample_len=%d-%d\n", AUTO_INSERTION_MAX,
+    AUTO_PRESORTED_DIV, AUTO_FEW_UNIQUE_PCT, AUTO_RADIX_MIN, AUTO_DENSE_MIN,
+    AUTO_SAMPLE_MIN, AUTO_SAMPLE_LEN);
+}
+
+/**
+ * `auto_sort`
+ *
+ *   Sorts an array with `sort_auto` without recording its profile.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+static void auto_sort(int * const arr, const size_t len) {
+  sort_auto(arr, len, NULL);
+}
+
+/**
+ * `parallel_sort`
+ *
+ *   Sorts an array with `numa_sort` on every processor and every node. Its
+ *   threads are joined before it returns, so their hardware counters and
+ *   operation counts are included in those of the calling thread.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+static void parallel_sort(int * const arr, const size_t len) {
+  const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+  numa_sort(arr, len, cpus > 1 ? (size_t)cpus : 1, 0);
+}
+
+/**
+ * `benchmark`
+ *
+ *   Sorts a copy of an array with each algorithm and prints the time and the
+ *   hardware event counts per element. When compiled with `SORT_COUNT_OPS`,
+ *   also prints the comparisons, swaps, and moves per element.
+ *
+ * @param orig
+ *   The unsorted array.
+ *
+ * @param arr
+ *   An array of the same length to sort the copies in.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param fp
+ *   The fingerprint of the unsorted array.
+ *
+ * @return
+ *   0 if every algorithm sorted the array correctly, or 1 otherwise.
+ */
+static int benchmark(const int * const orig, int * const arr, const int len,
+  const sort_fingerprint * const fp) {
+  perf_counters pc;
+  unsigned long long counts[PERF_EVENTS];
+  struct timespec start, end;
+  double ns;
+  size_t a;
+  int i, status = 0;
+
+  perf_counters_open(&pc);
+
+  /*** Print the header. ***/
+  printf("\n%-16s %10s", "per element", "ns");
+  for(i = 0; i < PERF_EVENTS; i++) {
+    printf(" %10s", perf_event_name(i));
+  }
+#ifdef SORT_COUNT_OPS
+  printf(" %10s %10s %10s", "cmps", "swaps", "moves");
+#endif
+  printf("\n");
+
+  for(a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+    printf("%-16s", ALGORITHMS[a].name);
+    if(ALGORITHMS[a].quadratic && len > QUADRATIC_MAX_N) {
+      printf(" %10s\n", "skipped");
+      continue;
+    }
+
+    /*** Sort a fresh copy of the array. ***/
+    memcpy(arr, orig, sizeof(int) * len);
+#ifdef SORT_COUNT_OPS
+    memset(&sort_op_counts, 0, sizeof(sort_op_counts));
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    perf_counters_start(&pc);
+    ALGORITHMS[a].sort(arr, len);
+    perf_counters_stop(&pc, counts);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /*** Print the counts per element. ***/
+    ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf(" %10.2f", ns / len);
+    for(i = 0; i < PERF_EVENTS; i++) {
+      if(counts[i] == PERF_UNAVAILABLE) {
+        printf(" %10s", "-");
+      }
+      else {
+        printf(" %10.3f", (double)counts[i] / len);
+      }
+    }
+#ifdef SORT_COUNT_OPS
+    printf(" %10.3f %10.3f %10.3f", (double)sort_op_counts.cmps / len,
+      (double)sort_op_counts.swaps / len, (double)sort_op_counts.moves / len);
+#endif
+    printf("\n");
+    status |= report_test(test_arr(arr, len, fp));
+  }
+
+  perf_counters_close(&pc);
+  return status;
+}
+
+/**
+ * `report_test`
+ *
+ *   Prints an error message for a failed `test_arr`.
+ *
+ * @param result
+ *   The result of `test_arr`.
+ *
+ * @return
+ *   0 if the test passed, or 1 otherwise.
+ */
+static int report_test(const int result) {
+  if(result == TEST_UNSORTED) {
+    printf("error: failed to sort array.\n");
+  }
+  else if(result == TEST_NOT_PERMUTATION) {
+    printf("error: sorted array is not a permutation of the input.\n");
+  }
+  return result != TEST_OK;
+}
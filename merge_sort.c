@@ -2,14 +2,24 @@
   File: merge_sort.c
   Author: CJ Dimaano
   Date created: March 6, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   Merge sort is a comparison-based sorting algorithm. It works by dividing an
   array into halves, sorting each sub-array, and merging the two halves back
   together. Merge sort is recursive and will recurse until the sub-array it is
   working on has 2 or less elements.
+
+  Merging only needs to copy the left half out of the way, so the scratch
+  memory is half the length of the array. It is taken from a sort context once
+  for the whole sort.
+
+  Key-value pairs are merge sorted the same way, moving each pair as a unit
+  and comparing only the keys. Merge sort is stable, so pairs with equal keys
+  keep their order.
 *******************************************************************************/
 
+#include <string.h>
+
 #include "sort.h"
 
 /**
@@ -25,51 +35,60 @@
  *
  * @param mid
  *   The midpoint of the array.
+ *
+ * @param tmp
+ *   Scratch memory with room for `mid` elements.
  */
-static void merge(int * const arr, const size_t len, const size_t mid) {
-  int temp[len];  /* Temporary array to hold sorted elements. */
-  size_t i;          /* Main iterator. */
+static void merge(int * const arr, const size_t len, const size_t mid,
+  int * const tmp) {
+  size_t i = 0;      /* Main iterator. */
   size_t j = 0;      /* Left sub-array iterator. */
   size_t k = mid;    /* Right sub-array iterator. */
 
+  /*** Move the left sub-array out of the way. ***/
+  memcpy(tmp, arr, sizeof(int) * mid);
+
   /*** Merge the two sub-arrays. ***/
-  for(i = 0; i < len; i++) {
-    if(j >= mid || (k < len && arr[j] > arr[k])) {
-      temp[i] = arr[k];
-      k++;
+  while(j < mid && k < len) {
+    if(LESS(arr[k], tmp[j])) {
+      arr[i++] = arr[k++];
     }
     else {
-      temp[i] = arr[j];
-      j++;
+      arr[i++] = tmp[j++];
     }
   }
 
-  /*** Update the array. ***/
-  for(i = 0; i < len; i++) {
-    arr[i] = temp[i];
+  /*** Copy the rest of the left sub-array. The rest of the right sub-array ***/
+  /*** is already in place.                                                 ***/
+  while(j < mid) {
+    arr[i++] = tmp[j++];
   }
+  MOVED(mid + i);
 }
 
 
 /**
- * `merge_sort`
+ * `sort`
  *
- *   Uses the merge sort algorithm to sort an array of integers.
+ *   Recursively sorts an array using scratch memory for merging.
  *
  * @param arr
  *   The array to be sorted.
  *
  * @param len
  *   The length of the array.
+ *
+ * @param tmp
+ *   Scratch memory with room for half of the elements.
  */
-void merge_sort(int * const arr, const size_t len) {
-  int mid;  /* Middle index. */
+static void sort(int * const arr, const size_t len, int * const tmp) {
+  size_t mid;  /* Middle index. */
 
   /*** Base case. ***/
   /***   Swap the left and right elements if the left is greater than the ***/
   /***   right.                                                           ***/
   if(len == 2) {
-    if(arr[0] > arr[1]) {
+    if(LESS(arr[1], arr[0])) {
       swap(arr, 0, 1);
     }
   }
@@ -78,12 +97,187 @@ void merge_sort(int * const arr, const size_t len) {
   /***   Split the array into halves, sort each sub-array, and merge. ***/
   else if(len > 2) {
     mid = (len >> 1);
-    merge_sort(arr, mid);
-    merge_sort((arr + mid), len - mid);
+    sort(arr, mid, tmp);
+    sort((arr + mid), len - mid, tmp);
 
     /*** Only merge if the middle two elements are unsorted. ***/
-    if(arr[mid - 1] > arr[mid]) {
-      merge(arr, len, mid);
+    if(LESS(arr[mid], arr[mid - 1])) {
+      merge(arr, len, mid, tmp);
+    }
+  }
+}
+
+
+/**
+ * `merge_sort`
+ *
+ *   Uses the merge sort algorithm to sort an array of integers.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+void merge_sort(int * const arr, const size_t len) {
+  sort_ctx ctx;
+
+  /*** Fall back to an in-place sort if there is no scratch memory. ***/
+  sort_ctx_init(&ctx, 0, 0);
+  if(merge_sort_ctx(arr, len, &ctx) != 0) {
+    quicksort_3way(arr, len);
+  }
+  sort_ctx_free(&ctx);
+}
+
+
+/**
+ * `merge_sort_ctx`
+ *
+ *   Uses the merge sort algorithm to sort an array of integers, taking its
+ *   scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int merge_sort_ctx(int * const arr, const size_t len, sort_ctx * const ctx) {
+  int *tmp = (int *)sort_ctx_scratch(ctx, sizeof(int) * ((len >> 1) + 1));
+
+  if(tmp == NULL) {
+    return -1;
+  }
+
+  sort(arr, len, tmp);
+  return 0;
+}
+
+
+/**
+ * `merge_kv`
+ *
+ *   Merges two sub-arrays of key-value pairs in sorted order.
+ *
+ * @param arr
+ *   The beginning of the array containing the sub-arrays to be merged.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param mid
+ *   The midpoint of the array.
+ *
+ * @param tmp
+ *   Scratch memory with room for `mid` pairs.
+ */
+static void merge_kv(sort_kv * const arr, const size_t len, const size_t mid,
+  sort_kv * const tmp) {
+  size_t i = 0;      /* Main iterator. */
+  size_t j = 0;      /* Left sub-array iterator. */
+  size_t k = mid;    /* Right sub-array iterator. */
+
+  /*** Move the left sub-array out of the way. ***/
+  memcpy(tmp, arr, sizeof(sort_kv) * mid);
+
+  /*** Merge the two sub-arrays, taking from the left on equal keys. ***/
+  while(j < mid && k < len) {
+    if(LESS(arr[k].key, tmp[j].key)) {
+      arr[i++] = arr[k++];
+    }
+    else {
+      arr[i++] = tmp[j++];
+    }
+  }
+
+  /*** Copy the rest of the left sub-array. ***/
+  while(j < mid) {
+    arr[i++] = tmp[j++];
+  }
+  MOVED(mid + i);
+}
+
+
+/**
+ * `sort_kv_rec`
+ *
+ *   Recursively sorts an array of key-value pairs using scratch memory for
+ *   merging.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param tmp
+ *   Scratch memory with room for half of the pairs.
+ */
+static void sort_kv_rec(sort_kv * const arr, const size_t len,
+  sort_kv * const tmp) {
+  size_t mid;  /* Middle index. */
+  sort_kv pair;
+
+  /*** Base case. ***/
+  if(len == 2) {
+    if(LESS(arr[1].key, arr[0].key)) {
+      pair = arr[0];
+      arr[0] = arr[1];
+      arr[1] = pair;
+      MOVED(2);
+    }
+  }
+
+  /*** Recurse case. ***/
+  else if(len > 2) {
+    mid = (len >> 1);
+    sort_kv_rec(arr, mid, tmp);
+    sort_kv_rec((arr + mid), len - mid, tmp);
+
+    /*** Only merge if the middle two pairs are unsorted. ***/
+    if(LESS(arr[mid].key, arr[mid - 1].key)) {
+      merge_kv(arr, len, mid, tmp);
     }
   }
-}
\ No newline at end of file
+}
+
+
+/**
+ * `merge_sort_kv`
+ *
+ *   Uses the merge sort algorithm to stably sort an array of key-value pairs
+ *   by key.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int merge_sort_kv(sort_kv * const arr, const size_t len,
+  sort_ctx * const ctx) {
+  sort_kv *tmp = (sort_kv *)sort_ctx_scratch(ctx,
+    sizeof(sort_kv) * ((len >> 1) + 1));
+
+  if(tmp == NULL) {
+    return -1;
+  }
+
+  sort_kv_rec(arr, len, tmp);
+  return 0;
+}
@@ -0,0 +1,628 @@
+/*******************************************************************************
+  File: numa_sort.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  NUMA-aware parallel sort. On a machine with several NUMA nodes, memory is
+  placed on the node of the thread that first touches it, and a thread reading
+  memory on another node goes through the interconnect. A parallel sort that
+  works in one buffer allocated and filled by the main thread therefore has
+  all of its pages on one node, and every other node sorts remotely.
+
+  Here each thread is pinned to a node and first copies its chunk of the array
+  into the arena of its own sort context, so the copy and the radix sort
+  scratch memory are both placed on its node when the thread first touches
+  them, and stay there as long as the context is used by a thread on the same
+  node. The chunks are sorted independently with no traffic between nodes.
+
+  The sorted chunks are then exchanged in one pass. The output is divided by
+  rank into the same ranges as the chunks, and each thread finds where its
+  first and last rank fall in every sorted chunk with a binary search over the
+  values. It copies those parts of the chunks in blocks, so each element
+  crosses the interconnect at most once, and then merges them pairwise,
+  back and forth between its range of the array and local memory. The merge is
+  branchless, since parts from different chunks interleave unpredictably.
+
+  The threads are created in both phases rather than waiting on a barrier, so
+  a thread that cannot be created is run on the calling thread instead, and
+  the calling thread is never pinned. The operation counts of each thread are
+  added to those of the calling thread when it is joined.
+
+  With `NUMA_SORT_IN_PLACE`, the sort is the NUMA-oblivious baseline instead:
+  the chunks are sorted in place in the array, the exchange merges into the
+  arenas of the contexts, which the caller may have allocated, and the merged
+  ranges are then copied back into the array.
+
+  Built with `SORT_NUMA` and linked with libnuma, the threads are pinned with
+  `numa_run_on_node`. Otherwise, or where `numa_available` fails, the sort
+  still runs in parallel but the placement is left to the scheduler.
+*******************************************************************************/
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SORT_NUMA
+#include <numa.h>
+#endif
+
+#include "sort.h"
+
+/**
+ * `NUMA_MAX_NODES`
+ *
+ *   Largest number of nodes the threads are spread over.
+ */
+#define NUMA_MAX_NODES 64
+
+/**
+ * `part`
+ *
+ *   The work of one thread: a chunk of the array to be sorted, and then the
+ *   same range of the array to be merged into.
+ */
+typedef struct part part;
+struct part {
+  int *arr;              /* The whole array. */
+  size_t first;          /* Index of the first element of the range. */
+  size_t last;           /* Index after the last element of the range. */
+  int node;              /* Node to run on, or -1 to run anywhere. */
+  int flags;             /* Flags given to numa_sort_ctx. */
+  sort_ctx *ctx;         /* The thread's context. */
+  int *run;              /* Sorted chunk, in the arena unless in place. */
+  int *merged;           /* The merged range, if not in the array. */
+  const part *parts;     /* Every part, for the exchange. */
+  size_t nparts;         /* The number of parts. */
+  sort_ops ops;          /* Operations counted on the part's thread. */
+};
+
+/**
+ * `task`
+ *
+ *   A function to be run on a part on a new thread.
+ */
+typedef struct {
+  part *p;
+  void *(*fn)(void *);
+} task;
+
+/**
+ * `find_nodes`
+ *
+ *   Finds the NUMA nodes that have processors.
+ *
+ * @param ids
+ *   Set to the ids of the nodes.
+ *
+ * @return
+ *   The number of nodes found, or 0 if NUMA is not available.
+ */
+static size_t find_nodes(int ids[NUMA_MAX_NODES]) {
+  size_t n = 0;
+#ifdef SORT_NUMA
+  struct bitmask *cpus;
+  int node;
+
+  if(numa_available() < 0) {
+    return 0;
+  }
+  cpus = numa_allocate_cpumask();
+  for(node = 0; node <= numa_max_node() && n < NUMA_MAX_NODES; node++) {
+    if(numa_bitmask_isbitset(numa_all_nodes_ptr, node)
+      && numa_node_to_cpus(node, cpus) == 0
+      && numa_bitmask_weight(cpus) > 0) {
+      ids[n++] = node;
+    }
+  }
+  numa_free_cpumask(cpus);
+#else
+  (void)ids;
+#endif
+  return n;
+}
+
+/**
+ * `pin`
+ *
+ *   Pins the calling thread to a node, and makes the memory it touches first
+ *   be placed there.
+ *
+ * @param node
+ *   The node, or -1 to leave the thread where it is.
+ */
+static void pin(const int node) {
+#ifdef SORT_NUMA
+  if(node >= 0 && numa_run_on_node(node) == 0) {
+    numa_set_localalloc();
+  }
+#else
+  (void)node;
+#endif
+}
+
+/**
+ * `count_below`
+ *
+ *   Counts the elements of a sorted array that are less than a value.
+ *
+ * @param arr
+ *   The sorted array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param val
+ *   The value, which may be outside the range of `int`.
+ *
+ * @return
+ *   The number of elements less than the value.
+ */
+static size_t count_below(const int * const arr, const size_t len,
+  const long long val) {
+  size_t lo = 0, hi = len, mid;
+
+  while(lo < hi) {
+    mid = lo + ((hi - lo) >> 1);
+    if(LESS((long long)arr[mid], val)) {
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * `select_rank`
+ *
+ *   Splits every sorted chunk so that the elements before the splits are the
+ *   `rank` smallest elements of all of the chunks. Equal elements are taken
+ *   from the chunks in order, so the splits for a larger rank are never before
+ *   the splits for a smaller one.
+ *
+ * @param parts
+ *   The parts holding the sorted chunks.
+ *
+ * @param nparts
+ *   The number of parts.
+ *
+ * @param rank
+ *   The number of elements before the splits.
+ *
+ * @param pos
+ *   Set to the split in each chunk.
+ */
+static void select_rank(const part * const parts, const size_t nparts,
+  const size_t rank, size_t pos[NUMA_MAX_THREADS]) {
+  long long lo = INT_MIN, hi = INT_MAX, mid;
+  size_t r, count, len, take, need = rank;
+
+  /*** Find the smallest value with at least `rank` elements not greater ***/
+  /*** than it.                                                           ***/
+  while(lo < hi) {
+    mid = lo + ((hi - lo) >> 1);
+    count = 0;
+    for(r = 0; r < nparts; r++) {
+      len = parts[r].last - parts[r].first;
+      count += count_below(parts[r].run, len, mid + 1);
+    }
+    if(count >= rank) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1;
+    }
+  }
+
+  /*** Take every element less than the value, and then as many elements ***/
+  /*** equal to it as are still needed.                                  ***/
+  for(r = 0; r < nparts; r++) {
+    len = parts[r].last - parts[r].first;
+    pos[r] = count_below(parts[r].run, len, lo);
+    need -= pos[r];
+  }
+  for(r = 0; r < nparts && need > 0; r++) {
+    len = parts[r].last - parts[r].first;
+    take = count_below(parts[r].run, len, lo + 1) - pos[r];
+    take = take < need ? take : need;
+    pos[r] += take;
+    need -= take;
+  }
+}
+
+/**
+ * `merge_pair`
+ *
+ *   Merges two sorted runs without branching on the elements.
+ *
+ * @param a
+ *   The first run.
+ *
+ * @param alen
+ *   The length of the first run.
+ *
+ * @param b
+ *   The second run.
+ *
+ * @param blen
+ *   The length of the second run.
+ *
+ * @param out
+ *   The array to merge into, with room for both runs.
+ */
+static inline void merge_pair(const int * const a, const size_t alen,
+  const int * const b, const size_t blen, int * const out) {
+  size_t i = 0, j = 0, k = 0;
+  int take_b;
+
+  while(i < alen && j < blen) {
+    take_b = LESS(b[j], a[i]);
+    out[k++] = take_b ? b[j] : a[i];
+    j += take_b;
+    i += !take_b;
+  }
+  memcpy(out + k, a + i, sizeof(int) * (alen - i));
+  memcpy(out + k + alen - i, b + j, sizeof(int) * (blen - j));
+}
+
+/**
+ * `merge_passes`
+ *
+ *   Merges adjacent sorted runs pairwise, back and forth between two arrays,
+ *   until one run is left.
+ *
+ * @param src
+ *   The array holding the runs.
+ *
+ * @param dst
+ *   An array of the same length.
+ *
+ * @param bounds
+ *   The offsets of the runs. Run `i` starts at `bounds[i]` and ends before
+ *   `bounds[i + 1]`. Updated as the runs are merged.
+ *
+ * @param runs
+ *   The number of runs.
+ *
+ * @return
+ *   The array holding the merged run, `src` or `dst`.
+ */
+static int *merge_passes(int *src, int *dst, size_t * const bounds,
+  size_t runs) {
+  size_t i, merged;
+  int *tmp;
+
+  while(runs > 1) {
+    for(i = 0, merged = 0; i + 1 < runs; i += 2, merged++) {
+      merge_pair(src + bounds[i], bounds[i + 1] - bounds[i],
+        src + bounds[i + 1], bounds[i + 2] - bounds[i + 1],
+        dst + bounds[i]);
+      bounds[merged] = bounds[i];
+    }
+    if(i < runs) {
+      memcpy(dst + bounds[i], src + bounds[i],
+        sizeof(int) * (bounds[i + 1] - bounds[i]));
+      bounds[merged++] = bounds[i];
+    }
+    bounds[merged] = bounds[runs];
+    runs = merged;
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  return src;
+}
+
+/**
+ * `sort_chunk`
+ *
+ *   Copies a chunk of the array into the arena of the part's context and
+ *   sorts it there. The arena holds twice the chunk: the copy is kept in the
+ *   second half, since the radix sort takes its scratch memory from the start
+ *   of the arena, and the first half is then free for the exchange.
+ *
+ * @param arg
+ *   The part. `run` is left NULL if the scratch memory cannot be allocated.
+ *
+ * @return
+ *   NULL.
+ */
+static void *sort_chunk(void *arg) {
+  part * const p = (part *)arg;
+  const size_t len = p->last - p->first;
+  int *buf;
+
+  pin(p->node);
+  buf = (int *)sort_ctx_scratch(p->ctx, sizeof(int) * (len << 1));
+  if(buf == NULL) {
+    return NULL;
+  }
+  if(p->flags & NUMA_SORT_IN_PLACE) {
+    p->run = p->arr + p->first;
+  }
+  else {
+    p->run = buf + len;
+    memcpy(p->run, p->arr + p->first, sizeof(int) * len);
+    MOVED(len);
+  }
+  if(radix_lsd_sort_ctx(p->run, len, p->ctx) != 0) {
+    p->run = NULL;
+  }
+  return NULL;
+}
+
+/**
+ * `merge_range`
+ *
+ *   Gathers the elements of every sorted chunk that belong in the part's
+ *   range of the array, and merges them into it.
+ *
+ * @param arg
+ *   The part.
+ *
+ * @return
+ *   NULL.
+ */
+static void *merge_range(void *arg) {
+  part * const p = (part *)arg;
+  const size_t len = p->last - p->first;
+  size_t lo[NUMA_MAX_THREADS], hi[NUMA_MAX_THREADS];
+  size_t bounds[NUMA_MAX_THREADS + 1];
+  size_t r, runs = 0, passes = 0;
+  int * const buf = (int *)p->ctx->arena;
+  int *gather, *other, *out = p->arr + p->first, *spare = buf;
+
+  pin(p->node);
+  select_rank(p->parts, p->nparts, p->first, lo);
+  select_rank(p->parts, p->nparts, p->last, hi);
+
+  /*** In place, the chunks are still being read from the array, so the ***/
+  /*** range is merged in the arena and copied back once every thread   ***/
+  /*** has finished.                                                    ***/
+  if(p->flags & NUMA_SORT_IN_PLACE) {
+    out = buf + len;
+  }
+
+  /*** Gather into whichever of the two buffers the merge passes will    ***/
+  /*** finish in.                                                        ***/
+  for(r = 0; r < p->nparts; r++) {
+    runs += hi[r] > lo[r];
+  }
+  for(r = 1; r < runs; r <<= 1) {
+    passes++;
+  }
+  gather = passes & 1 ? spare : out;
+  other = passes & 1 ? out : spare;
+
+  /*** Copy each part across the interconnect once, in one block. ***/
+  bounds[0] = 0;
+  for(r = 0, runs = 0; r < p->nparts; r++) {
+    if(hi[r] > lo[r]) {
+      memcpy(gather + bounds[runs], p->parts[r].run + lo[r],
+        sizeof(int) * (hi[r] - lo[r]));
+      bounds[runs + 1] = bounds[runs] + (hi[r] - lo[r]);
+      runs++;
+    }
+  }
+  MOVED(len);
+
+  p->merged = merge_passes(gather, other, bounds, runs);
+  MOVED(len * passes);
+  return NULL;
+}
+
+/**
+ * `copy_back`
+ *
+ *   Copies the merged range of a part back into the array.
+ *
+ * @param arg
+ *   The part.
+ *
+ * @return
+ *   NULL.
+ */
+static void *copy_back(void *arg) {
+  part * const p = (part *)arg;
+
+  pin(p->node);
+  memcpy(p->arr + p->first, p->merged, sizeof(int) * (p->last - p->first));
+  MOVED(p->last - p->first);
+  return NULL;
+}
+
+/**
+ * `start_part`
+ *
+ *   Runs a function on a part on a new thread, and keeps the operations the
+ *   thread counted.
+ *
+ * @param arg
+ *   The part, followed by the function in a `task`.
+ *
+ * @return
+ *   NULL.
+ */
+static void *start_part(void *arg) {
+  task * const tk = (task *)arg;
+
+  tk->fn(tk->p);
+#ifdef SORT_COUNT_OPS
+  tk->p->ops = sort_op_counts;
+#endif
+  return NULL;
+}
+
+/**
+ * `run_parts`
+ *
+ *   Runs a function on each part, one thread per part. A part whose thread
+ *   cannot be created is run on the calling thread without pinning it.
+ *
+ * @param parts
+ *   The parts.
+ *
+ * @param n
+ *   The number of parts.
+ *
+ * @param fn
+ *   The function to run on each part.
+ */
+static void run_parts(part * const parts, const size_t n,
+  void *(*fn)(void *)) {
+  pthread_t tids[NUMA_MAX_THREADS];
+  task tasks[NUMA_MAX_THREADS];
+  int started[NUMA_MAX_THREADS];
+  size_t t;
+
+  for(t = 0; t < n; t++) {
+    tasks[t].p = &parts[t];
+    tasks[t].fn = fn;
+    started[t] = pthread_create(&tids[t], NULL, start_part, &tasks[t]) == 0;
+    if(!started[t]) {
+      parts[t].node = -1;
+      fn(&parts[t]);
+    }
+  }
+  for(t = 0; t < n; t++) {
+    if(started[t]) {
+      pthread_join(tids[t], NULL);
+#ifdef SORT_COUNT_OPS
+      sort_op_counts.cmps += parts[t].ops.cmps;
+      sort_op_counts.swaps += parts[t].ops.swaps;
+      sort_op_counts.moves += parts[t].ops.moves;
+#endif
+    }
+  }
+}
+
+/**
+ * `numa_sort`
+ *
+ *   Sorts an array with several threads, keeping each thread's memory on its
+ *   own NUMA node.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param threads
+ *   The number of threads. 0 or 1 sorts the array on the calling thread.
+ *
+ * @param nodes
+ *   The number of nodes to spread the threads over, 0 for every node with
+ *   processors, or 1 to leave the threads unpinned.
+ *
+ * @return
+ *   The number of nodes the threads were pinned across, or 1 if they were not
+ *   pinned.
+ */
+size_t numa_sort(int * const arr, const size_t len, const size_t threads,
+  const size_t nodes) {
+  sort_ctx ctxs[NUMA_MAX_THREADS];
+  size_t t, n, used;
+
+  n = threads < 1 ? 1 : threads;
+  n = n > NUMA_MAX_THREADS ? NUMA_MAX_THREADS : n;
+
+  for(t = 0; t < n; t++) {
+    sort_ctx_init(&ctxs[t], 0, 0);
+  }
+  used = numa_sort_ctx(arr, len, ctxs, n, nodes, 0);
+  for(t = 0; t < n; t++) {
+    sort_ctx_free(&ctxs[t]);
+  }
+  return used;
+}
+
+/**
+ * `numa_sort_ctx`
+ *
+ *   Sorts an array with several threads, keeping each thread's memory on its
+ *   own NUMA node, and taking it from one sort context per thread.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctxs
+ *   The sort contexts, one for each thread.
+ *
+ * @param threads
+ *   The number of threads. 1 sorts the array on the calling thread.
+ *
+ * @param nodes
+ *   The number of nodes to spread the threads over, 0 for every node with
+ *   processors, or 1 to leave the threads unpinned.
+ *
+ * @param flags
+ *   0, or `NUMA_SORT_IN_PLACE` for the NUMA-oblivious baseline.
+ *
+ * @return
+ *   The number of nodes the threads were pinned across, or 1 if they were not
+ *   pinned.
+ */
+size_t numa_sort_ctx(int * const arr, const size_t len, sort_ctx * const ctxs,
+  const size_t threads, const size_t nodes, const int flags) {
+  part parts[NUMA_MAX_THREADS];
+  int ids[NUMA_MAX_NODES];
+  size_t t, n, found, used;
+  int failed = 0;
+
+  n = threads > NUMA_MAX_THREADS ? NUMA_MAX_THREADS : threads;
+  if(n <= 1 || len < NUMA_PARALLEL_MIN) {
+    if(radix_lsd_sort_ctx(arr, len, &ctxs[0]) != 0) {
+      quicksort_3way(arr, len);
+    }
+    return 1;
+  }
+
+  /*** Spread the threads evenly over the nodes. Threads are only pinned ***/
+  /*** when there is more than one node to spread them over.             ***/
+  found = find_nodes(ids);
+  used = nodes > 0 ? nodes : found;
+  used = found < 1 || used < 1 ? 1 : used;
+  used = used > n ? n : used;
+  used = used > NUMA_MAX_NODES ? NUMA_MAX_NODES : used;
+
+  for(t = 0; t < n; t++) {
+    parts[t].arr = arr;
+    parts[t].first = len / n * t;
+    parts[t].last = t == n - 1 ? len : len / n * (t + 1);
+    parts[t].node = used > 1 ? ids[t * used / n % found] : -1;
+    parts[t].flags = flags;
+    parts[t].ctx = &ctxs[t];
+    parts[t].run = NULL;
+    parts[t].merged = NULL;
+    parts[t].parts = parts;
+    parts[t].nparts = n;
+  }
+
+  /*** Sort the chunks on their nodes. ***/
+  run_parts(parts, n, sort_chunk);
+  for(t = 0; t < n; t++) {
+    failed |= parts[t].run == NULL;
+  }
+
+  /*** Exchange the sorted chunks back into the array, or fall back to ***/
+  /*** sorting on the calling thread if a chunk could not be sorted. In ***/
+  /*** place, the chunks that were sorted are still a permutation.      ***/
+  if(failed) {
+    if(radix_lsd_sort_ctx(arr, len, &ctxs[0]) != 0) {
+      quicksort_3way(arr, len);
+    }
+    return 1;
+  }
+  run_parts(parts, n, merge_range);
+  if(flags & NUMA_SORT_IN_PLACE) {
+    run_parts(parts, n, copy_back);
+  }
+  return used;
+}
@@ -0,0 +1,185 @@
+/*******************************************************************************
+  File: perf_counters.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Hardware performance counters read through the Linux perf_event_open system
+  call. Each event is opened as its own counter for the calling thread, so an
+  event the processor or the virtual machine does not support does not prevent
+  the others from being counted. The counters are inherited by the threads the
+  calling thread creates, and their counts are added in as they exit, so a
+  parallel sort whose threads are joined before the counters are stopped is
+  counted in full. On other systems no counters are available.
+*******************************************************************************/
+
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * `CACHE_READ_MISS`
+ *
+ *   Macro to build the config of a cache read miss event.
+ */
+#define CACHE_READ_MISS(cache) ((cache) \
+  | (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+  | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/**
+ * `EVENTS`
+ *
+ *   The type and config of each event.
+ */
+static const struct {
+  unsigned int type;
+  unsigned long long config;
+} EVENTS[PERF_EVENTS] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+  { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+  { PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB) }
+};
+#endif
+
+/**
+ * `NAMES`
+ *
+ *   The short name of each event.
+ */
+static const char * const NAMES[PERF_EVENTS] = {
+  "cycles", "instr", "br-miss", "L1d-miss", "LLC-miss", "dTLB-miss"
+};
+
+/**
+ * `perf_counters_open`
+ *
+ *   Opens the hardware performance counters for the calling thread and the
+ *   threads it creates.
+ *
+ * @param pc
+ *   The counters to be opened.
+ *
+ * @return
+ *   The number of counters that were opened.
+ */
+int perf_counters_open(perf_counters * const pc) {
+  int i, opened = 0;
+#ifdef __linux__
+  struct perf_event_attr attr;
+#endif
+
+  for(i = 0; i < PERF_EVENTS; i++) {
+    pc->fds[i] = -1;
+#ifdef __linux__
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = EVENTS[i].type;
+    attr.config = EVENTS[i].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    pc->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if(pc->fds[i] >= 0) {
+      opened++;
+    }
+#endif
+  }
+  return opened;
+}
+
+/**
+ * `perf_counters_start`
+ *
+ *   Resets and starts the counters.
+ *
+ * @param pc
+ *   The counters to be started.
+ */
+void perf_counters_start(perf_counters * const pc) {
+  int i;
+
+  for(i = 0; i < PERF_EVENTS; i++) {
+#ifdef __linux__
+    if(pc->fds[i] >= 0) {
+      ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)pc;
+#endif
+  }
+}
+
+/**
+ * `perf_counters_stop`
+ *
+ *   Stops the counters and reads their counts.
+ *
+ * @param pc
+ *   The counters to be stopped.
+ *
+ * @param counts
+ *   Set to the count of each event, or `PERF_UNAVAILABLE`.
+ */
+void perf_counters_stop(perf_counters * const pc,
+  unsigned long long counts[PERF_EVENTS]) {
+  int i;
+
+  for(i = 0; i < PERF_EVENTS; i++) {
+    counts[i] = PERF_UNAVAILABLE;
+#ifdef __linux__
+    if(pc->fds[i] >= 0) {
+      ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      if(read(pc->fds[i], &counts[i], sizeof(counts[i]))
+        != (ssize_t)sizeof(counts[i])) {
+        counts[i] = PERF_UNAVAILABLE;
+      }
+    }
+#endif
+  }
+}
+
+/**
+ * `perf_counters_close`
+ *
+ *   Closes the counters.
+ *
+ * @param pc
+ *   The counters to be closed.
+ */
+void perf_counters_close(perf_counters * const pc) {
+  int i;
+
+  for(i = 0; i < PERF_EVENTS; i++) {
+#ifdef __linux__
+    if(pc->fds[i] >= 0) {
+      close(pc->fds[i]);
+    }
+#endif
+    pc->fds[i] = -1;
+  }
+}
+
+/**
+ * `perf_event_name`
+ *
+ *   Gets the short name of an event.
+ *
+ * @param i
+ *   The index of the event.
+ *
+ * @return
+ *   The name of the event.
+ */
+const char *perf_event_name(const int i) {
+  return i >= 0 && i < PERF_EVENTS ? NAMES[i] : "unknown";
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+  File: perf_counters.h
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+*******************************************************************************/
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/**
+ * `PERF_EVENTS`
+ *
+ *   Number of hardware events counted.
+ */
+#define PERF_EVENTS 6
+
+/**
+ * `PERF_UNAVAILABLE`
+ *
+ *   Count reported for an event that could not be counted.
+ */
+#define PERF_UNAVAILABLE (~0ULL)
+
+/**
+ * `perf_counters`
+ *
+ *   Hardware performance counters for cycles, instructions, branch misses,
+ *   L1 data cache read misses, last level cache read misses, and data TLB
+ *   read misses, in that order.
+ */
+typedef struct {
+  int fds[PERF_EVENTS];  /* File descriptor of each counter, or -1. */
+} perf_counters;
+
+
+/**
+ * `perf_counters_open`
+ *
+ *   Opens the hardware performance counters for the calling thread and the
+ *   threads it creates.
+ *
+ *   Counters that the system does not support or does not allow are left
+ *   closed and reported as `PERF_UNAVAILABLE`.
+ *
+ * @param pc
+ *   The counters to be opened.
+ *
+ * @return
+ *   The number of counters that were opened.
+ */
+int perf_counters_open(perf_counters * const pc);
+
+
+/**
+ * `perf_counters_start`
+ *
+ *   Resets and starts the counters.
+ *
+ * @param pc
+ *   The counters to be started.
+ */
+void perf_counters_start(perf_counters * const pc);
+
+
+/**
+ * `perf_counters_stop`
+ *
+ *   Stops the counters and reads their counts.
+ *
+ * @param pc
+ *   The counters to be stopped.
+ *
+ * @param counts
+ *   Set to the count of each event, or `PERF_UNAVAILABLE`.
+ */
+void perf_counters_stop(perf_counters * const pc,
+  unsigned long long counts[PERF_EVENTS]);
+
+
+/**
+ * `perf_counters_close`
+ *
+ *   Closes the counters.
+ *
+ * @param pc
+ *   The counters to be closed.
+ */
+void perf_counters_close(perf_counters * const pc);
+
+
+/**
+ * `perf_event_name`
+ *
+ *   Gets the short name of an event.
+ *
+ * @param i
+ *   The index of the event.
+ *
+ * @return
+ *   The name of the event.
+ */
+const char *perf_event_name(const int i);
+
+
+#endif
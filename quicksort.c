@@ -2,7 +2,7 @@
   File: quicksort.c
   Author: CJ Dimaano
   Date created: March 6, 2016
-  Last updated: April 6, 2016
+  Last updated: October 19, 2026
   
   Quicksort is a comparison-based sorting algorithm. It works by partitioning an
   array and recursively sorting both sides of the partition. Partitioning
@@ -37,13 +37,13 @@ static inline size_t partition(int * const arr, const size_t len) {
 
     /*** Move the left index to the first element that is not less than the ***/
     /*** pivot. ***/
-    while(left < right && arr[left] < arr[pivot]) {
+    while(left < right && LESS(arr[left], arr[pivot])) {
       left++;
     }
 
     /*** Move the right index to the first element that is not greater-than ***/
     /*** or equal to the pivot, or up to the left index.                    ***/
-    while(right > left && arr[right] >= arr[pivot]) {
+    while(right > left && !LESS(arr[right], arr[pivot])) {
       right--;
     }
 
@@ -57,7 +57,7 @@ static inline size_t partition(int * const arr, const size_t len) {
   }
 
   /*** Swap the left element with the pivot. ***/
-  if(arr[left] < arr[pivot]) {
+  if(LESS(arr[left], arr[pivot])) {
     left++;
   }
   swap(arr, left, pivot);
@@ -0,0 +1,98 @@
+/*******************************************************************************
+  File: quicksort_3way.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Three-way quicksort is a variation of quicksort for arrays with many
+  duplicate elements. Partitioning divides the array into three parts instead
+  of two: elements less than the pivot, elements equal to the pivot, and
+  elements greater than the pivot. Only the outer two parts are sorted
+  recursively, so an array with only a few distinct elements is sorted in
+  close to linear time.
+*******************************************************************************/
+
+#include "sort.h"
+
+/**
+ * `partition_3way`
+ *
+ *   Partitions an array by arranging elements less than a pivot value onto one
+ *   side, elements greater than the pivot value onto the other side, and
+ *   elements equal to the pivot value in the middle.
+ *
+ * @param arr
+ *   The array to partition.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param lt
+ *   Set to the index of the first element equal to the pivot.
+ *
+ * @param gt
+ *   Set to the index of the first element greater than the pivot.
+ */
+static inline void partition_3way(int * const arr, const size_t len,
+  size_t * const lt, size_t * const gt) {
+  size_t left = 0;
+  size_t right = len;
+  size_t i = 0;
+  int pivot = arr[len >> 1];
+
+  /*** Move each element into its part of the array. ***/
+  while(i < right) {
+    if(LESS(arr[i], pivot)) {
+      swap(arr, left, i);
+      left++;
+      i++;
+    }
+    else if(LESS(pivot, arr[i])) {
+      right--;
+      swap(arr, i, right);
+    }
+    else {
+      i++;
+    }
+  }
+
+  *lt = left;
+  *gt = right;
+}
+
+
+/**
+ * `quicksort_3way`
+ *
+ *   Uses the three-way quicksort algorithm to sort an array of integers.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+void quicksort_3way(int * const arr, const size_t len) {
+  size_t lt, gt;
+  size_t length = len;
+  int *array = arr;
+
+  /*** Keep sorting the sub-array while its length is greater than 1. ***/
+  while(length > 1) {
+
+    /*** Partition the sub-array and obtain the bounds of the middle part. ***/
+    partition_3way(array, length, &lt, &gt);
+
+    /*** Sort the smaller of the outer parts and update the bounds of the ***/
+    /*** working array to the larger.                                    ***/
+    if(lt > length - gt) {
+      quicksort_3way((array + gt), length - gt);
+      length = lt;
+    }
+    else {
+      quicksort_3way(array, lt);
+      array = array + gt;
+      length = length - gt;
+    }
+  }
+}
@@ -2,7 +2,7 @@
   File: radix_lsd_sort.c
   Author: CJ Dimaano
   Date created: April 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   Radix sort is a sorting algorithm that takes advantage of integer properties.
   It is built on top of the counting sort algorithm. The idea behind counting
@@ -20,23 +20,138 @@
   sort LSD (least significant digit) works by using counting sort on the least
   significant digit first and working its way up. No comparisons are made in
   this algorithm.
+
+  The range of the elements is found before sorting, and the minimum is
+  subtracted from each element so that only the bits that differ between
+  elements need to be sorted. When the range is less than half the number of
+  elements, a single counting sort is used, with 32-bit counts held in the
+  arena. Otherwise the digit width (8, 11, or 16 bits) is chosen to minimize
+  the total cost of the passes and their counts arrays. The counts and the
+  buffer used between passes are taken from a sort context.
+
+  Key-value pairs with 64-bit keys are sorted the same way, either stored
+  together as an array of pairs, or as separate arrays of keys and values that
+  are rearranged together in each pass. A pass is skipped when every key has
+  the same digit.
 *******************************************************************************/
 
+#include <limits.h>
+#include <string.h>
+
 #include "sort.h"
 
 /**
- * `RADIX`
+ * `COUNTING_RANGE_DIV`
+ *
+ *   Counting sort is used when the range of the elements is less than the
+ *   length of the array divided by this. Above that, writing the elements
+ *   back from mostly single counts costs more than the radix passes.
+ */
+#ifndef COUNTING_RANGE_DIV
+#define COUNTING_RANGE_DIV 2
+#endif
+
+/**
+ * `DIGIT`
+ *
+ *   Macro to calculate the index into the counts array for a key that has had
+ *   the minimum subtracted.
+ */
+#define DIGIT(x, shift, mask) (((x) >> (shift)) & (mask))
+
+/**
+ * `counting_sort`
+ *
+ *   Uses the counting sort algorithm to sort an array of integers with a small
+ *   range.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param min
+ *   The smallest element in the array.
+ *
+ * @param range
+ *   The largest element in the array minus the smallest.
  *
- *   Number of bits per "digit" used in the counting sort algorithm.
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the counts array could not be allocated.
  */
-#define RADIX 256
+static int counting_sort(int * const arr, const size_t len,
+  const unsigned int min, const unsigned int range, sort_ctx * const ctx) {
+  size_t i, j, k;
+  unsigned int *counts;
+
+  /*** Counts are 32 bits, so they take no more memory than a copy of the ***/
+  /*** array, and are held in the arena since no copy is needed.         ***/
+  if(len > UINT_MAX) {
+    return -1;
+  }
+  counts = (unsigned int *)sort_ctx_scratch(ctx,
+    sizeof(unsigned int) * ((size_t)range + 1));
+  if(counts == NULL) {
+    return -1;
+  }
+  memset(counts, 0, sizeof(unsigned int) * ((size_t)range + 1));
+
+  /*** Count the number of occurances of each element. ***/
+  for(i = 0; i < len; i++) {
+    counts[(unsigned int)arr[i] - min]++;
+  }
+
+  /*** Write each element back as many times as it was counted. ***/
+  for(i = 0, k = 0; i <= range; i++) {
+    for(j = 0; j < counts[i]; j++) {
+      arr[k++] = (int)(min + (unsigned int)i);
+    }
+  }
+  MOVED(len);
+
+  return 0;
+}
 
 /**
- * `INDEX`
+ * `digit_width`
+ *
+ *   Chooses the number of bits per digit that minimizes the total work of the
+ *   counting sort passes for a range of keys.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param bits
+ *   The number of significant bits in the range of the keys.
+ *
+ * @param passes
+ *   Set to the number of passes needed with the chosen digit width.
  *
- *   Macro to calculate the index into the counts array.
+ * @return
+ *   The number of bits per digit.
  */
-#define INDEX(x, y) (((x) & (0xFF << ((y) << 3))) >> ((y) << 3))
+static unsigned int digit_width(const size_t len, const unsigned int bits,
+  unsigned int * const passes) {
+  static const unsigned int widths[] = { 8, 11, 16 };
+  unsigned int i, n, best = 8;
+  size_t cost, best_cost = (size_t)-1;
+
+  /*** Each pass visits every element twice and every count twice. ***/
+  for(i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+    n = (bits + widths[i] - 1) / widths[i];
+    cost = (size_t)n * (len + ((size_t)1 << widths[i]));
+    if(cost < best_cost) {
+      best_cost = cost;
+      best = widths[i];
+      *passes = n;
+    }
+  }
+  return best;
+}
 
 /**
  * `radix_lsd_sort`
@@ -50,40 +165,367 @@
  *   The length of the array.
 */
 void radix_lsd_sort(int * const arr, const size_t len) {
-  size_t i, j, k;
-  size_t counts[RADIX];
-  int old[len];
-  int tmp;
+  sort_ctx ctx;
+
+  /*** Fall back to an in-place sort if there is no scratch memory. ***/
+  sort_ctx_init(&ctx, 0, 0);
+  if(radix_lsd_sort_ctx(arr, len, &ctx) != 0) {
+    quicksort_3way(arr, len);
+  }
+  sort_ctx_free(&ctx);
+}
+
+/**
+ * `radix_lsd_sort_ctx`
+ *
+ *   Uses the radix (LSD) sort algorithm to sort an array of integers, taking
+ *   its scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+*/
+int radix_lsd_sort_ctx(int * const arr, const size_t len,
+  sort_ctx * const ctx) {
+  size_t i, j, sum, tmp;
+  int lo, hi;
+  unsigned int min, range, key, bits, width, mask, passes = 0;
+  size_t *counts;
+  int *buf, *src, *dst, *swp;
+
+  if(len < 2) {
+    return 0;
+  }
 
-  /*** Use counting sort by rearranging the elements for reach RADIX digit. ***/
-  for(i = 0; i < sizeof(int); i++) {
+  /*** Find the range of the elements. Keys are the elements minus the ***/
+  /*** minimum, so that negative elements sort before positive ones.   ***/
+  lo = hi = arr[0];
+  for(i = 1; i < len; i++) {
+    if(arr[i] < lo) {
+      lo = arr[i];
+    }
+    if(hi < arr[i]) {
+      hi = arr[i];
+    }
+  }
+  min = (unsigned int)lo;
+  range = (unsigned int)hi - min;
+  if(range == 0) {
+    return 0;
+  }
+
+  /*** Use a single counting sort if the range is small enough. ***/
+  if((size_t)range < len / COUNTING_RANGE_DIV
+    && counting_sort(arr, len, min, range, ctx) == 0) {
+    return 0;
+  }
+
+  /*** Choose the digit width from the number of bits in the range. ***/
+  for(bits = 0; bits < (sizeof(int) << 3) && (range >> bits) != 0; bits++);
+  width = digit_width(len, bits, &passes);
+  mask = (1u << width) - 1;
+
+  counts = sort_ctx_counts(ctx, (size_t)1 << width);
+  buf = (int *)sort_ctx_scratch(ctx, sizeof(int) * len);
+  if(counts == NULL || buf == NULL) {
+    return -1;
+  }
+
+  /*** Use counting sort by rearranging the elements for each digit, ***/
+  /*** alternating between the array and the buffer.                 ***/
+  src = arr;
+  dst = buf;
+  for(i = 0; i < passes; i++) {
 
-    /*** Copy the array elements into another array. ***/
+    /*** Set the counts of each digit to 0. ***/
+    memset(counts, 0, sizeof(size_t) << width);
+
+    /*** Count the number of occurances of each digit. ***/
     for(j = 0; j < len; j++) {
-      old[j] = arr[j];
+      key = (unsigned int)src[j] - min;
+      counts[DIGIT(key, i * width, mask)]++;
     }
 
-    /*** Set the counts of each RADIX digit to 0. ***/
-    for(j = 0; j < RADIX; j++) {
-      counts[j] = 0;
+    /*** Count the number of digits less than the current digit. ***/
+    for(j = 0, sum = 0; j <= mask; j++) {
+      tmp = counts[j];
+      counts[j] = sum;
+      sum += tmp;
     }
 
-    /*** Count the number of occurances of each RADIX digit. ***/
+    /*** Rearrange the elements according to their digit ordering. ***/
     for(j = 0; j < len; j++) {
-      counts[INDEX(old[j], i)]++;
+      key = (unsigned int)src[j] - min;
+      dst[counts[DIGIT(key, i * width, mask)]++] = src[j];
     }
+    MOVED(len);
+
+    swp = src;
+    src = dst;
+    dst = swp;
+  }
+
+  /*** Copy the elements back if the last pass left them in the buffer. ***/
+  if(src != arr) {
+    memcpy(arr, src, sizeof(int) * len);
+    MOVED(len);
+  }
+  return 0;
+}
 
-    /*** Count the number of RADIX digits less than or equal to the current ***/
-    /*** RADIX digit.                                                       ***/
-    for(j = 1; j < RADIX; j++) {
-      counts[j] += counts[j - 1];
+/**
+ * `offsets`
+ *
+ *   Turns the counts of each digit into the index of the first element with
+ *   that digit.
+ *
+ * @param counts
+ *   The counts of each digit.
+ *
+ * @param digits
+ *   The number of digits.
+ *
+ * @param len
+ *   The number of elements counted.
+ *
+ * @return
+ *   1 if every element has the same digit, so the pass can be skipped, or 0
+ *   otherwise.
+ */
+static int offsets(size_t * const counts, const size_t digits,
+  const size_t len) {
+  size_t j, sum, tmp;
+
+  for(j = 0, sum = 0; j < digits; j++) {
+    if(counts[j] == len) {
+      return 1;
+    }
+    tmp = counts[j];
+    counts[j] = sum;
+    sum += tmp;
+  }
+  return 0;
+}
+
+/**
+ * `key_plan`
+ *
+ *   Chooses the digit width and number of passes needed to sort 64-bit keys
+ *   with a given range.
+ *
+ * @param range
+ *   The largest key minus the smallest.
+ *
+ * @param len
+ *   The number of keys.
+ *
+ * @param passes
+ *   Set to the number of passes, or 0 if every key is the same.
+ *
+ * @return
+ *   The number of bits per digit.
+ */
+static unsigned int key_plan(const unsigned long long range, const size_t len,
+  unsigned int * const passes) {
+  unsigned int bits;
+
+  for(bits = 0; bits < (sizeof(range) << 3) && (range >> bits) != 0; bits++);
+  *passes = 0;
+  return bits == 0 ? 8 : digit_width(len, bits, passes);
+}
+
+/**
+ * `radix_lsd_sort_kv`
+ *
+ *   Uses the radix (LSD) sort algorithm to stably sort an array of key-value
+ *   pairs by key.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int radix_lsd_sort_kv(sort_kv * const arr, const size_t len,
+  sort_ctx * const ctx) {
+  size_t i, j;
+  unsigned long long min, max, key;
+  unsigned int width, mask, passes, shift;
+  size_t *counts;
+  sort_kv *buf, *src, *dst, *swp;
+
+  if(len < 2) {
+    return 0;
+  }
+
+  /*** Find the range of the keys. ***/
+  min = max = arr[0].key;
+  for(i = 1; i < len; i++) {
+    if(arr[i].key < min) {
+      min = arr[i].key;
+    }
+    if(max < arr[i].key) {
+      max = arr[i].key;
     }
+  }
+  width = key_plan(max - min, len, &passes);
+  if(passes == 0) {
+    return 0;
+  }
+  mask = (1u << width) - 1;
 
-    /*** Rearrange the elements according to their RADIX ordering. ***/
-    for(j = len - 1; j < len; j--) {
-      tmp = old[j];
-      k = (counts[INDEX(tmp, i)] -= 1);
-      arr[k] = tmp;
+  counts = sort_ctx_counts(ctx, (size_t)1 << width);
+  buf = (sort_kv *)sort_ctx_scratch(ctx, sizeof(sort_kv) * len);
+  if(counts == NULL || buf == NULL) {
+    return -1;
+  }
+
+  /*** Rearrange the pairs for each digit, alternating between the array ***/
+  /*** and the buffer.                                                   ***/
+  src = arr;
+  dst = buf;
+  for(i = 0; i < passes; i++) {
+    shift = i * width;
+    memset(counts, 0, sizeof(size_t) << width);
+    for(j = 0; j < len; j++) {
+      key = src[j].key - min;
+      counts[DIGIT(key, shift, mask)]++;
     }
+    if(offsets(counts, (size_t)mask + 1, len)) {
+      continue;
+    }
+
+    for(j = 0; j < len; j++) {
+      key = src[j].key - min;
+      dst[counts[DIGIT(key, shift, mask)]++] = src[j];
+    }
+    MOVED(len);
+
+    swp = src;
+    src = dst;
+    dst = swp;
+  }
+
+  /*** Copy the pairs back if the last pass left them in the buffer. ***/
+  if(src != arr) {
+    memcpy(arr, src, sizeof(sort_kv) * len);
+    MOVED(len);
+  }
+  return 0;
+}
+
+/**
+ * `radix_lsd_sort_kv_soa`
+ *
+ *   Uses the radix (LSD) sort algorithm to stably sort separate arrays of keys
+ *   and values by key. Each value is moved together with its key.
+ *
+ * @param keys
+ *   The keys to be sorted.
+ *
+ * @param vals
+ *   The values to be rearranged with the keys.
+ *
+ * @param len
+ *   The length of the arrays.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the arrays are unchanged.
+ */
+int radix_lsd_sort_kv_soa(unsigned long long * const keys,
+  unsigned long long * const vals, const size_t len, sort_ctx * const ctx) {
+  size_t i, j, k;
+  unsigned long long min, max, key;
+  unsigned int width, mask, passes, shift;
+  size_t *counts;
+  unsigned long long *buf, *src_k, *src_v, *dst_k, *dst_v, *swp;
+
+  if(len < 2) {
+    return 0;
+  }
+
+  /*** Find the range of the keys. ***/
+  min = max = keys[0];
+  for(i = 1; i < len; i++) {
+    if(keys[i] < min) {
+      min = keys[i];
+    }
+    if(max < keys[i]) {
+      max = keys[i];
+    }
+  }
+  width = key_plan(max - min, len, &passes);
+  if(passes == 0) {
+    return 0;
+  }
+  mask = (1u << width) - 1;
+
+  counts = sort_ctx_counts(ctx, (size_t)1 << width);
+  buf = (unsigned long long *)sort_ctx_scratch(ctx,
+    sizeof(unsigned long long) * len * 2);
+  if(counts == NULL || buf == NULL) {
+    return -1;
+  }
+
+  /*** Rearrange the keys and values together for each digit, alternating ***/
+  /*** between the arrays and the buffer.                                  ***/
+  src_k = keys;
+  src_v = vals;
+  dst_k = buf;
+  dst_v = buf + len;
+  for(i = 0; i < passes; i++) {
+    shift = i * width;
+    memset(counts, 0, sizeof(size_t) << width);
+    for(j = 0; j < len; j++) {
+      key = src_k[j] - min;
+      counts[DIGIT(key, shift, mask)]++;
+    }
+    if(offsets(counts, (size_t)mask + 1, len)) {
+      continue;
+    }
+
+    for(j = 0; j < len; j++) {
+      key = src_k[j] - min;
+      k = counts[DIGIT(key, shift, mask)]++;
+      dst_k[k] = src_k[j];
+      dst_v[k] = src_v[j];
+    }
+    MOVED(len << 1);
+
+    swp = src_k;
+    src_k = dst_k;
+    dst_k = swp;
+    swp = src_v;
+    src_v = dst_v;
+    dst_v = swp;
+  }
+
+  /*** Copy the keys and values back if the last pass left them in the ***/
+  /*** buffer.                                                         ***/
+  if(src_k != keys) {
+    memcpy(keys, src_k, sizeof(unsigned long long) * len);
+    memcpy(vals, src_v, sizeof(unsigned long long) * len);
+    MOVED(len << 1);
   }
+  return 0;
 }
@@ -0,0 +1,352 @@
+/*******************************************************************************
+  File: segmented_sort.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Segmented sort sorts many independent segments of one array in a single
+  call. The segments are described by an offsets array, where segment `i`
+  starts at `offsets[i]` and ends before `offsets[i + 1]`.
+
+  Segments are grouped by size class as they are visited. Segments of up to 8
+  or up to 16 elements are collected in groups of `LANES`; each group is
+  transposed so that element `k` of every segment in the group sits in one row,
+  padded with `INT_MAX`, and a sorting network is applied to the rows. Every
+  compare-exchange of the network then works on all of the segments in the
+  group at once. With GCC-compatible compilers the rows are vectors and each
+  compare-exchange is a handful of vector instructions.
+
+  Segments of up to `SEGMENT_INSERTION_MAX` elements are sorted with insertion
+  sort, and larger segments with radix sort, or three-way quicksort if its
+  scratch memory cannot be allocated.
+
+  The segments can be divided between threads. Each thread gets a contiguous
+  range of segments with roughly the same number of elements, and its own sort
+  context for the radix sort scratch memory.
+*******************************************************************************/
+
+#include <limits.h>
+#include <pthread.h>
+
+#include "sort.h"
+
+/**
+ * `LANES`
+ *
+ *   Number of segments sorted at once by a sorting network.
+ */
+#define LANES 8
+
+/**
+ * `SEGMENT_INSERTION_MAX`
+ *
+ *   Largest segment that is sorted with insertion sort.
+ */
+#define SEGMENT_INSERTION_MAX 48
+
+/**
+ * `NET8`
+ *
+ *   Batcher's odd-even merge sorting network for 8 elements.
+ */
+static const unsigned char NET8[][2] = {
+  {0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3}, {4, 6}, {5, 7}, {1, 2},
+  {5, 6}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {2, 4}, {3, 5}, {1, 2}, {3, 4},
+  {5, 6}
+};
+
+/**
+ * `NET16`
+ *
+ *   Batcher's odd-even merge sorting network for 16 elements.
+ */
+static const unsigned char NET16[][2] = {
+  {0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {12, 13}, {14, 15},
+  {0, 2}, {1, 3}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {12, 14}, {13, 15},
+  {1, 2}, {5, 6}, {9, 10}, {13, 14}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+  {8, 12}, {9, 13}, {10, 14}, {11, 15}, {2, 4}, {3, 5}, {10, 12}, {11, 13},
+  {1, 2}, {3, 4}, {5, 6}, {9, 10}, {11, 12}, {13, 14}, {0, 8}, {1, 9},
+  {2, 10}, {3, 11}, {4, 12}, {5, 13}, {6, 14}, {7, 15}, {4, 8}, {5, 9},
+  {6, 10}, {7, 11}, {2, 4}, {3, 5}, {6, 8}, {7, 9}, {10, 12}, {11, 13},
+  {1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12}, {13, 14}
+};
+
+/**
+ * `row`
+ *
+ *   One element from each of the segments in a group.
+ */
+#ifdef __GNUC__
+typedef int row __attribute__((vector_size(sizeof(int) * LANES)));
+#else
+typedef int row[LANES];
+#endif
+
+/**
+ * `group`
+ *
+ *   Segments of one size class waiting to be sorted by a sorting network.
+ */
+typedef struct {
+  size_t width;          /* Number of inputs of the sorting network. */
+  size_t count;          /* Number of segments in the group. */
+  size_t segs[LANES];    /* Index of each segment in the group. */
+} group;
+
+/**
+ * `job`
+ *
+ *   A range of segments to be sorted by one thread.
+ */
+typedef struct {
+  int *arr;
+  const size_t *offsets;
+  size_t first;          /* Index of the first segment. */
+  size_t last;           /* Index after the last segment. */
+  sort_ctx *ctx;         /* Scratch memory for the thread. */
+} job;
+
+/**
+ * `flush`
+ *
+ *   Sorts the segments in a group with a sorting network and empties the
+ *   group.
+ *
+ * @param arr
+ *   The array containing the segments.
+ *
+ * @param offsets
+ *   The offsets of the segments.
+ *
+ * @param grp
+ *   The group to be sorted.
+ */
+static void flush(int * const arr, const size_t * const offsets,
+  group * const grp) {
+  row rows[16];  /* Transposed segments. */
+  const unsigned char (*net)[2] = grp->width == 8 ? NET8 : NET16;
+  const size_t comps = grp->width == 8
+    ? sizeof(NET8) / sizeof(NET8[0])
+    : sizeof(NET16) / sizeof(NET16[0]);
+  size_t i, l, len;
+#ifdef __GNUC__
+  row a, b, lt;
+#else
+  int lo, hi;
+#endif
+
+  /*** Transpose the segments into the rows, padding with the largest ***/
+  /*** integer.                                                       ***/
+  for(l = 0; l < LANES; l++) {
+    len = l < grp->count
+      ? offsets[grp->segs[l] + 1] - offsets[grp->segs[l]]
+      : 0;
+    for(i = 0; i < grp->width; i++) {
+      rows[i][l] = i < len ? arr[offsets[grp->segs[l]] + i] : INT_MAX;
+    }
+  }
+
+  /*** Apply each compare-exchange of the network to every lane. ***/
+  for(i = 0; i < comps; i++) {
+#ifdef __GNUC__
+    a = rows[net[i][0]];
+    b = rows[net[i][1]];
+    lt = a < b;
+    rows[net[i][0]] = (a & lt) | (b & ~lt);
+    rows[net[i][1]] = (b & lt) | (a & ~lt);
+#else
+    for(l = 0; l < LANES; l++) {
+      lo = rows[net[i][0]][l] < rows[net[i][1]][l]
+        ? rows[net[i][0]][l] : rows[net[i][1]][l];
+      hi = rows[net[i][0]][l] < rows[net[i][1]][l]
+        ? rows[net[i][1]][l] : rows[net[i][0]][l];
+      rows[net[i][0]][l] = lo;
+      rows[net[i][1]][l] = hi;
+    }
+#endif
+  }
+
+  /*** Transpose the sorted rows back into the segments. ***/
+  for(l = 0; l < grp->count; l++) {
+    len = offsets[grp->segs[l] + 1] - offsets[grp->segs[l]];
+    for(i = 0; i < len; i++) {
+      arr[offsets[grp->segs[l]] + i] = rows[i][l];
+    }
+    MOVED(len);
+  }
+#ifdef SORT_COUNT_OPS
+  sort_op_counts.cmps += comps * grp->count;
+#endif
+
+  grp->count = 0;
+}
+
+/**
+ * `sort_range`
+ *
+ *   Sorts a range of segments.
+ *
+ * @param arg
+ *   The job describing the range of segments.
+ *
+ * @return
+ *   NULL.
+ */
+static void *sort_range(void *arg) {
+  const job * const jb = (const job *)arg;
+  group small = { 8, 0, { 0 } };
+  group medium = { 16, 0, { 0 } };
+  size_t i, len;
+  int *seg;
+
+  for(i = jb->first; i < jb->last; i++) {
+    seg = jb->arr + jb->offsets[i];
+    len = jb->offsets[i + 1] - jb->offsets[i];
+
+    /*** Collect small segments into groups for the sorting networks. ***/
+    if(len <= 1) {
+      continue;
+    }
+    else if(len <= 8) {
+      small.segs[small.count++] = i;
+      if(small.count == LANES) {
+        flush(jb->arr, jb->offsets, &small);
+      }
+    }
+    else if(len <= 16) {
+      medium.segs[medium.count++] = i;
+      if(medium.count == LANES) {
+        flush(jb->arr, jb->offsets, &medium);
+      }
+    }
+
+    /*** Sort larger segments on their own. ***/
+    else if(len <= SEGMENT_INSERTION_MAX) {
+      insertion_sort(seg, len);
+    }
+    else if(radix_lsd_sort_ctx(seg, len, jb->ctx) != 0) {
+      quicksort_3way(seg, len);
+    }
+  }
+
+  /*** Sort the partially filled groups. ***/
+  if(small.count > 0) {
+    flush(jb->arr, jb->offsets, &small);
+  }
+  if(medium.count > 0) {
+    flush(jb->arr, jb->offsets, &medium);
+  }
+  return NULL;
+}
+
+/**
+ * `segmented_sort`
+ *
+ *   Sorts each segment of an array independently.
+ *
+ * @param arr
+ *   The array containing the segments.
+ *
+ * @param offsets
+ *   The offsets of the segments. Segment `i` starts at `offsets[i]` and ends
+ *   before `offsets[i + 1]`, so there are `segs + 1` offsets.
+ *
+ * @param segs
+ *   The number of segments.
+ *
+ * @param threads
+ *   The number of threads to divide the segments between. 0 or 1 sorts the
+ *   segments on the calling thread.
+ */
+void segmented_sort(int * const arr, const size_t * const offsets,
+  const size_t segs, const size_t threads) {
+  sort_ctx ctxs[SEGMENT_MAX_THREADS];
+  size_t t, n;
+
+  n = threads < 1 ? 1 : threads;
+  n = n > SEGMENT_MAX_THREADS ? SEGMENT_MAX_THREADS : n;
+
+  for(t = 0; t < n; t++) {
+    sort_ctx_init(&ctxs[t], 0, 0);
+  }
+  segmented_sort_ctx(arr, offsets, segs, ctxs, n);
+  for(t = 0; t < n; t++) {
+    sort_ctx_free(&ctxs[t]);
+  }
+}
+
+/**
+ * `segmented_sort_ctx`
+ *
+ *   Sorts each segment of an array independently, taking scratch memory from
+ *   one sort context per thread.
+ *
+ * @param arr
+ *   The array containing the segments.
+ *
+ * @param offsets
+ *   The offsets of the segments. Segment `i` starts at `offsets[i]` and ends
+ *   before `offsets[i + 1]`, so there are `segs + 1` offsets.
+ *
+ * @param segs
+ *   The number of segments.
+ *
+ * @param ctxs
+ *   The sort contexts, one for each thread.
+ *
+ * @param threads
+ *   The number of threads to divide the segments between. 1 sorts the
+ *   segments on the calling thread.
+ */
+void segmented_sort_ctx(int * const arr, const size_t * const offsets,
+  const size_t segs, sort_ctx * const ctxs, const size_t threads) {
+  pthread_t tids[SEGMENT_MAX_THREADS];
+  job jobs[SEGMENT_MAX_THREADS];
+  size_t t, n, lo, hi, mid, target;
+  size_t total = offsets[segs] - offsets[0];
+
+  n = threads < 1 ? 1 : threads;
+  n = n > SEGMENT_MAX_THREADS ? SEGMENT_MAX_THREADS : n;
+  n = n > segs ? segs : n;
+
+  /*** Divide the segments so each thread gets about the same number of ***/
+  /*** elements.                                                         ***/
+  for(t = 0; t < n; t++) {
+    jobs[t].arr = arr;
+    jobs[t].offsets = offsets;
+    jobs[t].ctx = &ctxs[t];
+    jobs[t].first = t == 0 ? 0 : jobs[t - 1].last;
+
+    /*** Find the first segment that starts at or after the target. ***/
+    target = offsets[0] + total / n * (t + 1);
+    lo = jobs[t].first;
+    hi = segs;
+    while(t < n - 1 && lo < hi) {
+      mid = lo + ((hi - lo) >> 1);
+      if(offsets[mid] < target) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    jobs[t].last = t == n - 1 ? segs : lo;
+  }
+
+  /*** Sort the first range on the calling thread. Fall back to sorting a ***/
+  /*** range there too if a thread cannot be created.                     ***/
+  for(t = 1; t < n; t++) {
+    if(pthread_create(&tids[t], NULL, sort_range, &jobs[t]) != 0) {
+      sort_range(&jobs[t]);
+      jobs[t].arr = NULL;
+    }
+  }
+  if(n > 0) {
+    sort_range(&jobs[0]);
+  }
+  for(t = 1; t < n; t++) {
+    if(jobs[t].arr != NULL) {
+      pthread_join(tids[t], NULL);
+    }
+  }
+}
@@ -2,7 +2,7 @@
   File: selection_sort.c
   Author: CJ Dimaano
   Date created: March 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   Selection sort is a comparison-based sorting algorithm. It works by selecting
   each element in an array and swapping it with the best element in the unsorted
@@ -36,7 +36,7 @@ void selection_sort(int * const arr, const size_t len) {
 
     /*** Search the remainder of the array for the best element. ***/
     for(j = i + 1; j < len; j++) {
-      if(arr[best] > arr[j]) {
+      if(LESS(arr[j], arr[best])) {
         best = j;
       }
     }
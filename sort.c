@@ -2,14 +2,17 @@
   File: sort.c
   Author: CJ Dimaano
   Date created: March 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
 *******************************************************************************/
 
-#include <stdio.h>
 #include <stdlib.h>
 
 #include "sort.h"
 
+#ifdef SORT_COUNT_OPS
+_Thread_local sort_ops sort_op_counts;
+#endif
+
 /**
  * `init_arr`
  *
@@ -38,32 +41,6 @@ void init_arr(int * const arr, const size_t len) {
   }
 }
 
-/**
- * `test_arr`
- *
- *   Checks if an array is sorted in ascending order.
- *
- * @param arr
- *   The array to be checked.
- *
- * @param len
- *  The length of the array.
- */
-void test_arr(const int * const arr, const size_t len) {
-  size_t i;  /* Iterator. */
-
-  /*** Make sure the previous element is not greater than the current ***/
-  /*** element.                                                       ***/
-  for(i = 1; i < len && arr[i - 1] <= arr[i]; i++);
-
-  /*** Print an error message if the array is not sorted. ***/
-  if(i < len) {
-    printf("error: failed to sort array.\n");
-    printf("\tarr[%u] = %d\n", (unsigned int)(i - 1), arr[i - 1]);
-    printf("\tarr[%u] = %d\n", (unsigned int)i, arr[i]);
-  }
-}
-
 /**
  * `swap`
  *
@@ -80,8 +57,11 @@ void test_arr(const int * const arr, const size_t len) {
  * @param j
  *   The index of the second element to be swapped.
  */
-inline void swap(int * const arr, const size_t i, const size_t j) {
+void swap(int * const arr, const size_t i, const size_t j) {
   int temp = arr[i];
+#ifdef SORT_COUNT_OPS
+  sort_op_counts.swaps++;
+#endif
   arr[i] = arr[j];
   arr[j] = temp;
 }
@@ -2,7 +2,7 @@
   File: sort.h
   Author: CJ Dimaano
   Date created: March 5, 2016
-  Last updated: April 5, 2016
+  Last updated: October 19, 2026
   
   
   TODO:
@@ -17,6 +17,235 @@
 
 #include <stdlib.h>
 
+/**
+ * `AUTO_INSERTION_MAX`
+ *
+ *   Largest array that `sort_auto` sorts with insertion sort.
+ */
+#ifndef AUTO_INSERTION_MAX
+#define AUTO_INSERTION_MAX 16
+#endif
+
+/**
+ * `AUTO_PRESORTED_DIV`
+ *
+ *   `sort_auto` treats an array as nearly sorted when it has no more than one
+ *   run for every `AUTO_PRESORTED_DIV` elements.
+ */
+#ifndef AUTO_PRESORTED_DIV
+#define AUTO_PRESORTED_DIV 8
+#endif
+
+/**
+ * `AUTO_FEW_UNIQUE_PCT`
+ *
+ *   `sort_auto` treats an array as having few distinct elements when no more
+ *   than this percentage of its sample is distinct.
+ */
+#ifndef AUTO_FEW_UNIQUE_PCT
+#define AUTO_FEW_UNIQUE_PCT 50
+#endif
+
+/**
+ * `AUTO_RADIX_MIN`
+ *
+ *   Smallest array that `sort_auto` sorts with radix sort.
+ */
+#ifndef AUTO_RADIX_MIN
+#define AUTO_RADIX_MIN 4096
+#endif
+
+/**
+ * `AUTO_DENSE_MIN`
+ *
+ *   Smallest array shorter than `AUTO_RADIX_MIN` that `sort_auto` sorts with
+ *   radix sort when the range of its elements is less than its length.
+ */
+#ifndef AUTO_DENSE_MIN
+#define AUTO_DENSE_MIN 64
+#endif
+
+/**
+ * `AUTO_SAMPLE_LEN`
+ *
+ *   Largest number of elements sampled by `sort_auto` to estimate how many
+ *   distinct elements an array has. An eighth of the array is sampled, but
+ *   no fewer than `AUTO_SAMPLE_MIN` elements, or the whole of a shorter
+ *   array, so that one repeat in a small sample does not decide.
+ */
+#ifndef AUTO_SAMPLE_LEN
+#define AUTO_SAMPLE_LEN 256
+#endif
+
+/**
+ * `AUTO_SAMPLE_MIN`
+ *
+ *   Smallest number of elements sampled by `sort_auto`.
+ */
+#ifndef AUTO_SAMPLE_MIN
+#define AUTO_SAMPLE_MIN 32
+#endif
+
+/**
+ * `TEST_OK`, `TEST_UNSORTED`, `TEST_NOT_PERMUTATION`
+ *
+ *   Results of `test_arr`.
+ */
+#define TEST_OK 0
+#define TEST_UNSORTED 1
+#define TEST_NOT_PERMUTATION 2
+
+/**
+ * `sort_fingerprint`
+ *
+ *   A fingerprint of the elements of an array that does not depend on their
+ *   order.
+ */
+typedef struct {
+  unsigned long long sum;      /* Sum of the elements. */
+  unsigned long long mix_sum;  /* Sum of the hashes of the elements. */
+  unsigned long long mix_xor;  /* Xor of the hashes of the elements. */
+} sort_fingerprint;
+
+/**
+ * `sort_kv`
+ *
+ *   A key-value pair, such as a key and the row it belongs to, sorted by key.
+ */
+typedef struct {
+  unsigned long long key;
+  unsigned long long val;
+} sort_kv;
+
+/**
+ * `sort_ops`
+ *
+ *   Counts of the operations performed by the sorting algorithms, kept when
+ *   compiled with `SORT_COUNT_OPS` defined. A move is a write of an element
+ *   other than through `swap`. The counts are kept per thread in
+ *   `sort_op_counts` and are never reset by the algorithms.
+ */
+typedef struct {
+  unsigned long long cmps;   /* Comparisons between elements. */
+  unsigned long long swaps;  /* Calls to swap. */
+  unsigned long long moves;  /* Elements written. */
+} sort_ops;
+
+/**
+ * `LESS`
+ *
+ *   Macro to compare two elements, counting the comparison.
+ *
+ * `MOVED`
+ *
+ *   Macro to count a number of elements written.
+ */
+#ifdef SORT_COUNT_OPS
+extern _Thread_local sort_ops sort_op_counts;
+#define LESS(x, y) (sort_op_counts.cmps++, (x) < (y))
+#define MOVED(n) (sort_op_counts.moves += (n))
+#else
+#define LESS(x, y) ((x) < (y))
+#define MOVED(n) ((void)0)
+#endif
+
+/**
+ * `SEGMENT_MAX_THREADS`
+ *
+ *   Largest number of threads used by `segmented_sort`.
+ */
+#ifndef SEGMENT_MAX_THREADS
+#define SEGMENT_MAX_THREADS 64
+#endif
+
+/**
+ * `NUMA_MAX_THREADS`
+ *
+ *   Largest number of threads used by `numa_sort`.
+ */
+#ifndef NUMA_MAX_THREADS
+#define NUMA_MAX_THREADS 64
+#endif
+
+/**
+ * `NUMA_PARALLEL_MIN`
+ *
+ *   Smallest array that `numa_sort` splits between threads. Shorter arrays
+ *   are radix sorted on the calling thread.
+ */
+#ifndef NUMA_PARALLEL_MIN
+#define NUMA_PARALLEL_MIN (1 << 16)
+#endif
+
+/**
+ * `NUMA_SORT_IN_PLACE`
+ *
+ *   Flag for `numa_sort_ctx` to sort the chunks in place in the array and
+ *   merge them through the contexts' arenas, without regard to where the
+ *   memory is. This is the NUMA-oblivious baseline `numa_sort` is compared to.
+ */
+#define NUMA_SORT_IN_PLACE 1
+
+/**
+ * `SORT_CTX_ALIGN`
+ *
+ *   Alignment in bytes of the scratch memory held by a sort context.
+ */
+#define SORT_CTX_ALIGN 64
+
+/**
+ * `SORT_CTX_HUGE_PAGES`
+ *
+ *   Flag for `sort_ctx_init` to back the arena with huge pages.
+ */
+#define SORT_CTX_HUGE_PAGES 1
+
+/**
+ * `sort_ctx`
+ *
+ *   Scratch memory reused by the sorting algorithms between calls. A context
+ *   is not thread-safe; each thread should use its own context.
+ */
+typedef struct {
+  void *arena;         /* Scratch memory for copies of the elements. */
+  size_t arena_len;    /* Size of the arena in bytes. */
+  int arena_mapped;    /* Whether the arena was mapped or allocated. */
+  size_t *counts;      /* Scratch memory for histograms. */
+  size_t counts_len;   /* Number of counts in the histogram memory. */
+  int flags;           /* Flags given to sort_ctx_init. */
+} sort_ctx;
+
+/**
+ * `sort_algo`
+ *
+ *   The sorting algorithms that `sort_auto` can select.
+ */
+typedef enum {
+  SORT_NONE,
+  SORT_INSERTION,
+  SORT_MERGE,
+  SORT_MERGE_REVERSED,
+  SORT_QUICK,
+  SORT_QUICK_3WAY,
+  SORT_RADIX_LSD
+} sort_algo;
+
+/**
+ * `sort_profile`
+ *
+ *   The properties of an array recorded by `sort_auto`.
+ */
+typedef struct {
+  size_t len;            /* Length of the array. */
+  int min;               /* Smallest element. */
+  int max;               /* Largest element. */
+  size_t runs;           /* Number of ascending runs. */
+  size_t reverse_runs;   /* Number of descending runs. */
+  size_t sample_len;     /* Number of elements sampled, 0 if not needed. */
+  size_t sample_unique;  /* Number of distinct elements in the sample. */
+  sort_algo algo;        /* The algorithm that was selected. */
+} sort_profile;
+
 /**
  * `init_arr`
  *
@@ -36,15 +265,178 @@ void init_arr(int * const arr, const size_t len);
 /**
  * `test_arr`
  *
- *   Checks if an array is sorted in ascending order.
+ *   Checks if an array is sorted in ascending order and, optionally, if it is
+ *   a permutation of the array it was sorted from.
  *
  * @param arr
  *   The array to be checked.
  *
  * @param len
  *  The length of the array.
+ *
+ * @param fp
+ *   The fingerprint of the array before it was sorted, or NULL to only check
+ *   the order.
+ *
+ * @return
+ *   `TEST_OK`, `TEST_UNSORTED`, or `TEST_NOT_PERMUTATION`.
+ */
+int test_arr(const int * const arr, const size_t len,
+  const sort_fingerprint * const fp);
+
+
+/**
+ * `test_arr_threads`
+ *
+ *   Checks if an array is sorted in ascending order and, optionally, if it is
+ *   a permutation of the array it was sorted from, with a limited number of
+ *   threads.
+ *
+ * @description
+ *   Same as `test_arr`, for callers that already check several arrays at
+ *   once, one per thread, and should pass 1 so the checks do not start
+ *   threads of their own.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param fp
+ *   The fingerprint of the array before it was sorted, or NULL to only check
+ *   the order.
+ *
+ * @param threads
+ *   The largest number of threads to use, or 0 for one per processor.
+ *
+ * @return
+ *   `TEST_OK`, `TEST_UNSORTED`, or `TEST_NOT_PERMUTATION`.
  */
-void test_arr(const int * const arr, const size_t len);
+int test_arr_threads(const int * const arr, const size_t len,
+  const sort_fingerprint * const fp, const size_t threads);
+
+
+/**
+ * `is_sorted_arr`
+ *
+ *   Finds the first element of an array that is out of ascending order.
+ *
+ * @description
+ *   The array is checked in blocks without branching inside a block, so the
+ *   check can be vectorized, and large arrays are split between threads.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @return
+ *   The index of the first element that is less than the element before it,
+ *   or `len` if the array is sorted.
+ */
+size_t is_sorted_arr(const int * const arr, const size_t len);
+
+
+/**
+ * `fingerprint_arr`
+ *
+ *   Computes a fingerprint of the elements of an array that does not depend on
+ *   their order.
+ *
+ * @description
+ *   The fingerprint is the sum of the elements and the sum and the xor of a
+ *   hash of each element. Any permutation of the same elements has the same
+ *   fingerprint; losing or duplicating elements changes it with high
+ *   probability. Large arrays are split between threads.
+ *
+ * @param arr
+ *   The array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param fp
+ *   Set to the fingerprint.
+ */
+void fingerprint_arr(const int * const arr, const size_t len,
+  sort_fingerprint * const fp);
+
+
+/**
+ * `sort_ctx_init`
+ *
+ *   Initializes a sort context.
+ *
+ * @description
+ *   A sort context holds an arena for temporary copies of the elements and a
+ *   counts array for histograms. Each only grows when a call needs more than it
+ *   already has, so repeated sorts of arrays up to a given size do not
+ *   allocate. Both are aligned to `SORT_CTX_ALIGN` bytes.
+ *
+ * @param ctx
+ *   The context to be initialized.
+ *
+ * @param len
+ *   The initial size of the arena in bytes. May be 0.
+ *
+ * @param flags
+ *   0, or `SORT_CTX_HUGE_PAGES` to back the arena with huge pages.
+ *
+ * @return
+ *   0 on success, or -1 if the arena could not be allocated.
+ */
+int sort_ctx_init(sort_ctx * const ctx, const size_t len, const int flags);
+
+
+/**
+ * `sort_ctx_free`
+ *
+ *   Frees the memory held by a sort context.
+ *
+ * @param ctx
+ *   The context to be freed.
+ */
+void sort_ctx_free(sort_ctx * const ctx);
+
+
+/**
+ * `sort_ctx_scratch`
+ *
+ *   Gets the arena of a sort context, growing it if it is too small.
+ *
+ *   The contents of the arena are not preserved when it grows.
+ *
+ * @param ctx
+ *   The context.
+ *
+ * @param len
+ *   The number of bytes needed.
+ *
+ * @return
+ *   The arena, or NULL if it could not be grown.
+ */
+void *sort_ctx_scratch(sort_ctx * const ctx, const size_t len);
+
+
+/**
+ * `sort_ctx_counts`
+ *
+ *   Gets the counts array of a sort context, growing it if it is too small.
+ *
+ *   The contents of the counts array are not initialized.
+ *
+ * @param ctx
+ *   The context.
+ *
+ * @param len
+ *   The number of counts needed.
+ *
+ * @return
+ *   The counts array, or NULL if it could not be grown.
+ */
+size_t *sort_ctx_counts(sort_ctx * const ctx, const size_t len);
 
 
 /**
@@ -63,7 +455,7 @@ void test_arr(const int * const arr, const size_t len);
  * @param j
  *   The index of the second element to be swapped.
  */
-inline void swap(int * const arr, const size_t i, const size_t j);
+void swap(int * const arr, const size_t i, const size_t j);
 
 
 /**
@@ -120,6 +512,10 @@ void insertion_sort(int * const arr, const size_t len);
  *   together. Merge sort is recursive and will recurse until the sub-array it
  *   is working on has 2 or less elements.
  *
+ *   If the scratch memory cannot be allocated, the array is sorted with
+ *   three-way quicksort instead, which is not stable. Use `merge_sort_ctx` to
+ *   detect this.
+ *
  * @param arr
  *   The array to be sorted.
  *
@@ -129,6 +525,28 @@ void insertion_sort(int * const arr, const size_t len);
 void merge_sort(int * const arr, const size_t len);
 
 
+/**
+ * `merge_sort_ctx`
+ *
+ *   Uses the merge sort algorithm to sort an array of integers, taking its
+ *   scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int merge_sort_ctx(int * const arr, const size_t len, sort_ctx * const ctx);
+
+
 /**
  * `quicksort`
  *
@@ -149,6 +567,27 @@ void merge_sort(int * const arr, const size_t len);
 void quicksort(int * const arr, const size_t len);
 
 
+/**
+ * `quicksort_3way`
+ *
+ *   Uses the three-way quicksort algorithm to sort an array of integers.
+ *
+ * @description
+ *   Three-way quicksort is a variation of quicksort for arrays with many
+ *   duplicate elements. Partitioning divides the array into elements less
+ *   than the pivot, elements equal to the pivot, and elements greater than the
+ *   pivot. Only the outer two parts are sorted recursively, so an array with
+ *   only a few distinct elements is sorted in close to linear time.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ */
+void quicksort_3way(int * const arr, const size_t len);
+
+
 /**
  * `heapsort`
  *
@@ -203,6 +642,15 @@ void heapsort(int * const arr, const size_t len);
  *   the least significant digit first and working its way up. No comparisons
  *   are made in this algorithm.
  *
+ *   The minimum element is subtracted from each element before sorting, so
+ *   negative elements are supported and only the bits that differ between
+ *   elements are sorted. A single counting sort is used when the range is
+ *   less than half the length of the array; otherwise the digit width (8,
+ *   11, or 16 bits) and the number of passes are chosen from the range.
+ *
+ *   If the scratch memory cannot be allocated, the array is sorted with
+ *   three-way quicksort instead. Use `radix_lsd_sort_ctx` to detect this.
+ *
  * @param arr
  *   The array to be sorted.
  *
@@ -212,6 +660,367 @@ void heapsort(int * const arr, const size_t len);
 void radix_lsd_sort(int * const arr, const size_t len);
 
 
+/**
+ * `radix_lsd_sort_ctx`
+ *
+ *   Uses the radix (LSD) sort algorithm to sort an array of integers, taking
+ *   its scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int radix_lsd_sort_ctx(int * const arr, const size_t len,
+  sort_ctx * const ctx);
+
+
+/**
+ * `merge_sort_kv`
+ *
+ *   Uses the merge sort algorithm to stably sort an array of key-value pairs
+ *   by key.
+ *
+ * @description
+ *   Pairs are moved as 16-byte units and only the keys are compared. Pairs
+ *   with equal keys keep their order.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int merge_sort_kv(sort_kv * const arr, const size_t len,
+  sort_ctx * const ctx);
+
+
+/**
+ * `radix_lsd_sort_kv`
+ *
+ *   Uses the radix (LSD) sort algorithm to stably sort an array of key-value
+ *   pairs by key.
+ *
+ * @description
+ *   Pairs are moved as 16-byte units. The minimum key is subtracted first and
+ *   the digit width is chosen from the range of the keys, as in
+ *   `radix_lsd_sort`; passes in which every key has the same digit are
+ *   skipped.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the array is unchanged.
+ */
+int radix_lsd_sort_kv(sort_kv * const arr, const size_t len,
+  sort_ctx * const ctx);
+
+
+/**
+ * `radix_lsd_sort_kv_soa`
+ *
+ *   Uses the radix (LSD) sort algorithm to stably sort separate arrays of keys
+ *   and values by key.
+ *
+ * @description
+ *   The keys and values are stored as a struct of arrays. Each pass reads
+ *   only the keys to count digits, and then moves each key and its value in
+ *   the same scatter.
+ *
+ * @param keys
+ *   The keys to be sorted.
+ *
+ * @param vals
+ *   The values to be rearranged with the keys.
+ *
+ * @param len
+ *   The length of the arrays.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @return
+ *   0 on success, or -1 if the scratch memory could not be allocated, in
+ *   which case the arrays are unchanged.
+ */
+int radix_lsd_sort_kv_soa(unsigned long long * const keys,
+  unsigned long long * const vals, const size_t len, sort_ctx * const ctx);
+
+
+/**
+ * `batch_insert`
+ *
+ *   Inserts a batch of elements into an already-sorted array.
+ *
+ * @description
+ *   Batch insertion maintains a sorted array as small batches of new elements
+ *   arrive, without re-sorting the whole array. The batch is sorted on its own
+ *   and then merged into the array from the back, so no temporary buffer is
+ *   needed. Each batch element finds its position by galloping backwards from
+ *   the end of the unmerged portion of the array, and the elements after it
+ *   are moved up in one block. The cost is proportional to the batch plus the
+ *   displaced tail of the array rather than the whole array.
+ *
+ * @param arr
+ *   The sorted array, with room for `batch_len` more elements after `len`.
+ *
+ * @param len
+ *   The number of sorted elements in the array.
+ *
+ * @param batch
+ *   The elements to be inserted. The batch is sorted in place.
+ *
+ * @param batch_len
+ *   The length of the batch.
+ */
+void batch_insert(int * const arr, const size_t len, int * const batch,
+  const size_t batch_len);
+
+
+/**
+ * `segmented_sort`
+ *
+ *   Sorts each segment of an array independently.
+ *
+ * @description
+ *   Segmented sort sorts many small arrays stored back to back in one call.
+ *   Segments of up to 8 or 16 elements are collected into groups of 8, and
+ *   each group is sorted with a sorting network applied to all of its
+ *   segments at once, so every compare-exchange becomes a vector min and max.
+ *   Larger segments are sorted with insertion sort or radix sort.
+ *   The segments can be divided between threads by number of elements.
+ *
+ * @param arr
+ *   The array containing the segments.
+ *
+ * @param offsets
+ *   The offsets of the segments. Segment `i` starts at `offsets[i]` and ends
+ *   before `offsets[i + 1]`, so there are `segs + 1` offsets.
+ *
+ * @param segs
+ *   The number of segments.
+ *
+ * @param threads
+ *   The number of threads to divide the segments between, up to
+ *   `SEGMENT_MAX_THREADS`. 0 or 1 sorts the segments on the calling thread.
+ */
+void segmented_sort(int * const arr, const size_t * const offsets,
+  const size_t segs, const size_t threads);
+
+
+/**
+ * `segmented_sort_ctx`
+ *
+ *   Sorts each segment of an array independently, taking scratch memory from
+ *   one sort context per thread.
+ *
+ * @param arr
+ *   The array containing the segments.
+ *
+ * @param offsets
+ *   The offsets of the segments. Segment `i` starts at `offsets[i]` and ends
+ *   before `offsets[i + 1]`, so there are `segs + 1` offsets.
+ *
+ * @param segs
+ *   The number of segments.
+ *
+ * @param ctxs
+ *   The sort contexts, one for each thread.
+ *
+ * @param threads
+ *   The number of threads to divide the segments between, up to
+ *   `SEGMENT_MAX_THREADS`. 1 sorts the segments on the calling thread.
+ */
+void segmented_sort_ctx(int * const arr, const size_t * const offsets,
+  const size_t segs, sort_ctx * const ctxs, const size_t threads);
+
+
+/**
+ * `numa_sort`
+ *
+ *   Sorts an array with several threads, keeping each thread's memory on its
+ *   own NUMA node.
+ *
+ * @description
+ *   The array is divided into one chunk per thread, and the threads are
+ *   spread evenly over the nodes and pinned to them. Each thread copies its
+ *   chunk into memory it touches first, so the pages are placed on its node,
+ *   and sorts the copy there with radix sort. The sorted chunks are then
+ *   exchanged: each thread selects its range of ranks from every chunk and
+ *   merges them back into the part of the array it copied from, so an array
+ *   that was first touched in the same chunks stays local. Built without
+ *   libnuma, or where NUMA is not available, the threads are not pinned and
+ *   the placement is left to the scheduler. Arrays shorter than
+ *   `NUMA_PARALLEL_MIN` are radix sorted on the calling thread.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param threads
+ *   The number of threads, up to `NUMA_MAX_THREADS`. 0 or 1 sorts the array on
+ *   the calling thread.
+ *
+ * @param nodes
+ *   The number of nodes to spread the threads over, 0 for every node with
+ *   processors, or 1 to leave the threads unpinned. More nodes than the
+ *   machine has are mapped onto its nodes in turn. Ignored, and the threads
+ *   left unpinned, when built without `SORT_NUMA` or where NUMA is not
+ *   available. The chunks are exchanged whenever there is more than one
+ *   thread, however many nodes are used.
+ *
+ * @return
+ *   The number of nodes the threads were pinned across, or 1 if they were not
+ *   pinned.
+ */
+size_t numa_sort(int * const arr, const size_t len, const size_t threads,
+  const size_t nodes);
+
+
+/**
+ * `numa_sort_ctx`
+ *
+ *   Sorts an array with several threads, keeping each thread's memory on its
+ *   own NUMA node, and taking it from one sort context per thread.
+ *
+ * @description
+ *   Each thread copies its chunk into the arena of its context, which holds
+ *   twice the chunk, so a context that is reused by a thread on the same node
+ *   keeps its pages there and does not allocate again. With
+ *   `NUMA_SORT_IN_PLACE`, the chunks are instead sorted in place in the array
+ *   and merged through the arenas, so the memory is wherever the caller first
+ *   touched it.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctxs
+ *   The sort contexts, one for each thread.
+ *
+ * @param threads
+ *   The number of threads, up to `NUMA_MAX_THREADS`. 1 sorts the array on the
+ *   calling thread.
+ *
+ * @param nodes
+ *   As for `numa_sort`.
+ *
+ * @param flags
+ *   0, or `NUMA_SORT_IN_PLACE` for the NUMA-oblivious baseline.
+ *
+ * @return
+ *   The number of nodes the threads were pinned across, or 1 if they were not
+ *   pinned.
+ */
+size_t numa_sort_ctx(int * const arr, const size_t len, sort_ctx * const ctxs,
+  const size_t threads, const size_t nodes, const int flags);
+
+
+/**
+ * `sort_auto`
+ *
+ *   Profiles an array and sorts it with the algorithm best suited for its
+ *   contents.
+ *
+ * @description
+ *   A single pass over the array records the range of its elements and the
+ *   number of ascending and descending runs. Tiny arrays are sorted with
+ *   insertion sort; arrays whose range is less than their length with radix
+ *   sort; and nearly sorted arrays (in either direction) with merge sort,
+ *   which only merges where runs meet. Otherwise a small sample is sorted to
+ *   estimate the number of distinct elements: arrays with few of them are
+ *   sorted with three-way quicksort, large arrays with radix sort, and the
+ *   rest with merge sort, which is never quadratic. The thresholds are the
+ *   `AUTO_*` macros above.
+ *
+ *   Scratch memory is allocated only for merge sort and radix sort, and is
+ *   freed before returning. Callers that sort many arrays should use
+ *   `sort_auto_ctx` with one context, so the memory is allocated once.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param prof
+ *   If not NULL, filled in with the profile of the array and the algorithm
+ *   that was selected.
+ *
+ * @return
+ *   The algorithm that was used to sort the array.
+ */
+sort_algo sort_auto(int * const arr, const size_t len,
+  sort_profile * const prof);
+
+
+/**
+ * `sort_algo_name`
+ *
+ *   Gets the name of the function that implements a sorting algorithm.
+ *
+ * @param algo
+ *   The sorting algorithm.
+ *
+ * @return
+ *   The name of the sorting algorithm.
+ */
+const char *sort_algo_name(const sort_algo algo);
+
+
+/**
+ * `sort_auto_ctx`
+ *
+ *   Profiles an array and sorts it with the algorithm best suited for its
+ *   contents, taking scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @param prof
+ *   If not NULL, filled in with the profile of the array and the algorithm
+ *   that was selected.
+ *
+ * @return
+ *   The algorithm that was used to sort the array.
+ */
+sort_algo sort_auto_ctx(int * const arr, const size_t len,
+  sort_ctx * const ctx, sort_profile * const prof);
+
+
 /**
  * `radix_msd_sort`
  *
@@ -0,0 +1,301 @@
+/*******************************************************************************
+  File: sort_auto.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Automatic algorithm selection profiles an array before sorting it and
+  dispatches to the algorithm best suited for its contents. A single pass over
+  the array records the minimum, the maximum, and the number of ascending and
+  descending runs; if those do not decide, a small evenly-spaced sample is
+  sorted to estimate how many distinct elements the array has. The thresholds
+  used to make the decision are defined in sort.h and can be overridden at
+  compile time. Scratch memory for the selected algorithm is taken from a sort
+  context.
+*******************************************************************************/
+
+#include "sort.h"
+
+/**
+ * `reverse`
+ *
+ *   Reverses the order of the elements in an array.
+ *
+ * @param arr
+ *   The array to be reversed.
+ *
+ * @param len
+ *   The length of the array.
+ */
+static void reverse(int * const arr, const size_t len) {
+  size_t i;
+
+  for(i = 0; i < (len >> 1); i++) {
+    swap(arr, i, len - i - 1);
+  }
+}
+
+
+/**
+ * `no_scratch`
+ *
+ *   Sorts an array with three-way quicksort when the selected algorithm
+ *   could not allocate its scratch memory, and records the change.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param prof
+ *   The profile to record the algorithm in.
+ */
+static void no_scratch(int * const arr, const size_t len,
+  sort_profile * const prof) {
+  prof->algo = SORT_QUICK_3WAY;
+  quicksort_3way(arr, len);
+}
+
+
+/**
+ * `profile_arr`
+ *
+ *   Records the range and the runs of an array, used to select a sorting
+ *   algorithm.
+ *
+ * @param arr
+ *   The array to be profiled.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param prof
+ *   The profile to be filled in.
+ */
+static void profile_arr(const int * const arr, const size_t len,
+  sort_profile * const prof) {
+  size_t i;
+  size_t ascents = 0;
+  size_t descents = 0;
+
+  prof->len = len;
+  prof->min = len > 0 ? arr[0] : 0;
+  prof->max = prof->min;
+
+  /*** Find the range of the elements and count the adjacent pairs that ***/
+  /*** are out of order in either direction.                            ***/
+  for(i = 1; i < len; i++) {
+    if(arr[i] < prof->min) {
+      prof->min = arr[i];
+    }
+    if(arr[i] > prof->max) {
+      prof->max = arr[i];
+    }
+    descents += (arr[i - 1] > arr[i]);
+    ascents += (arr[i - 1] < arr[i]);
+  }
+  prof->runs = descents + 1;
+  prof->reverse_runs = ascents + 1;
+  prof->sample_len = prof->sample_unique = 0;
+}
+
+
+/**
+ * `sample_arr`
+ *
+ *   Estimates how many distinct elements an array has by sorting a sample of
+ *   it. The sample is at most an eighth of the array, so that profiling a
+ *   small array does not cost as much as sorting it.
+ *
+ * @param arr
+ *   The array to be sampled.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param prof
+ *   The profile to fill in the sample counts of.
+ */
+static void sample_arr(const int * const arr, const size_t len,
+  sort_profile * const prof) {
+  int sample[AUTO_SAMPLE_LEN];  /* Evenly-spaced sample of the array. */
+  size_t i;
+
+  /*** Sort a sample of the array and count its distinct elements. ***/
+  prof->sample_len = (len >> 3) > AUTO_SAMPLE_MIN ? len >> 3 : AUTO_SAMPLE_MIN;
+  prof->sample_len = prof->sample_len < len ? prof->sample_len : len;
+  prof->sample_len = prof->sample_len < AUTO_SAMPLE_LEN
+    ? prof->sample_len : AUTO_SAMPLE_LEN;
+  for(i = 0; i < prof->sample_len; i++) {
+    sample[i] = arr[i * (len / prof->sample_len)];
+  }
+  quicksort_3way(sample, prof->sample_len);
+  prof->sample_unique = prof->sample_len > 0 ? 1 : 0;
+  for(i = 1; i < prof->sample_len; i++) {
+    prof->sample_unique += (sample[i - 1] != sample[i]);
+  }
+}
+
+
+/**
+ * `sort_algo_name`
+ *
+ *   Gets the name of the function that implements a sorting algorithm.
+ *
+ * @param algo
+ *   The sorting algorithm.
+ *
+ * @return
+ *   The name of the sorting algorithm.
+ */
+const char *sort_algo_name(const sort_algo algo) {
+  switch(algo) {
+    case SORT_NONE:           return "none";
+    case SORT_INSERTION:      return "insertion_sort";
+    case SORT_MERGE:          return "merge_sort";
+    case SORT_MERGE_REVERSED: return "reverse+merge_sort";
+    case SORT_QUICK:          return "quicksort";
+    case SORT_QUICK_3WAY:     return "quicksort_3way";
+    case SORT_RADIX_LSD:      return "radix_lsd_sort";
+  }
+  return "unknown";
+}
+
+
+/**
+ * `sort_auto`
+ *
+ *   Profiles an array and sorts it with the algorithm best suited for its
+ *   contents. The context starts empty, so nothing is allocated unless merge
+ *   sort or radix sort is selected; callers sorting many arrays should keep
+ *   one context and use `sort_auto_ctx`.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param prof
+ *   If not NULL, filled in with the profile of the array and the algorithm
+ *   that was selected.
+ *
+ * @return
+ *   The algorithm that was used to sort the array.
+ */
+sort_algo sort_auto(int * const arr, const size_t len,
+  sort_profile * const prof) {
+  sort_ctx ctx;
+  sort_algo algo;
+
+  sort_ctx_init(&ctx, 0, 0);
+  algo = sort_auto_ctx(arr, len, &ctx, prof);
+  sort_ctx_free(&ctx);
+  return algo;
+}
+
+
+/**
+ * `sort_auto_ctx`
+ *
+ *   Profiles an array and sorts it with the algorithm best suited for its
+ *   contents, taking scratch memory from a sort context.
+ *
+ * @param arr
+ *   The array to be sorted.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param ctx
+ *   The sort context.
+ *
+ * @param prof
+ *   If not NULL, filled in with the profile of the array and the algorithm
+ *   that was selected.
+ *
+ * @return
+ *   The algorithm that was used to sort the array.
+ */
+sort_algo sort_auto_ctx(int * const arr, const size_t len,
+  sort_ctx * const ctx, sort_profile * const prof) {
+  sort_profile local;
+  sort_profile * const p = prof != NULL ? prof : &local;
+
+  /*** Tiny arrays are not worth profiling. ***/
+  if(len <= AUTO_INSERTION_MAX) {
+    p->len = len;
+    p->min = p->max = 0;
+    p->runs = p->reverse_runs = 0;
+    p->sample_len = p->sample_unique = 0;
+    p->algo = SORT_INSERTION;
+    insertion_sort(arr, len);
+    return p->algo;
+  }
+
+  profile_arr(arr, len, p);
+
+  /*** Already sorted. ***/
+  if(p->runs == 1) {
+    p->algo = SORT_NONE;
+  }
+
+  /*** Dense keys: with a range below the length, radix sort needs fewer ***/
+  /*** passes than for the whole range of `int`, and a range below half  ***/
+  /*** the length is a single counting sort.                             ***/
+  else if(len >= AUTO_DENSE_MIN
+    && (size_t)((unsigned int)p->max - (unsigned int)p->min) < len) {
+    p->algo = SORT_RADIX_LSD;
+    if(radix_lsd_sort_ctx(arr, len, ctx) != 0) {
+      no_scratch(arr, len, p);
+    }
+  }
+
+  /*** Nearly sorted: merge sort only merges where the runs meet. ***/
+  else if(p->runs <= len / AUTO_PRESORTED_DIV) {
+    p->algo = SORT_MERGE;
+    if(merge_sort_ctx(arr, len, ctx) != 0) {
+      no_scratch(arr, len, p);
+    }
+  }
+
+  /*** Nearly sorted in reverse: reverse first, then merge the runs. ***/
+  else if(p->reverse_runs <= len / AUTO_PRESORTED_DIV) {
+    p->algo = SORT_MERGE_REVERSED;
+    reverse(arr, len);
+    if(merge_sort_ctx(arr, len, ctx) != 0) {
+      no_scratch(arr, len, p);
+    }
+  }
+
+  /*** Otherwise sample the array for distinct elements. ***/
+  else {
+    sample_arr(arr, len, p);
+
+    /*** Few distinct elements. ***/
+    if(p->sample_unique * 100 <= p->sample_len * AUTO_FEW_UNIQUE_PCT) {
+      p->algo = SORT_QUICK_3WAY;
+      quicksort_3way(arr, len);
+    }
+
+    /*** Large arrays. ***/
+    else if(len >= AUTO_RADIX_MIN) {
+      p->algo = SORT_RADIX_LSD;
+      if(radix_lsd_sort_ctx(arr, len, ctx) != 0) {
+        no_scratch(arr, len, p);
+      }
+    }
+
+    /*** Small arrays: merge sort, rather than a quicksort that is ***/
+    /*** quadratic on runs the presorted test let through.        ***/
+    else {
+      p->algo = SORT_MERGE;
+      if(merge_sort_ctx(arr, len, ctx) != 0) {
+        no_scratch(arr, len, p);
+      }
+    }
+  }
+
+  return p->algo;
+}
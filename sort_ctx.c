@@ -0,0 +1,248 @@
+/*******************************************************************************
+  File: sort_ctx.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  A sort context holds the scratch memory used by the sorting algorithms so
+  that it can be reused between calls. It has two regions: an arena for
+  temporary copies of the elements, and a counts array for histograms. Each
+  region only grows when a call needs more than it already has, so once a
+  context has sorted an array of a given size, sorting arrays up to that size
+  does not allocate any memory.
+
+  Regions are aligned to `SORT_CTX_ALIGN` bytes. If the context was created
+  with `SORT_CTX_HUGE_PAGES`, the arena is mapped with huge pages when the
+  system has them reserved, and otherwise the kernel is advised to back it
+  with transparent huge pages.
+
+  A context is not thread-safe; each thread should use its own context.
+*******************************************************************************/
+
+#include <string.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "sort.h"
+
+/**
+ * `HUGE_PAGE_SIZE`
+ *
+ *   Size of a huge page, used to round up huge-page-backed arenas.
+ */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/**
+ * `ROUND_UP`
+ *
+ *   Macro to round a size up to a multiple of a power of two.
+ */
+#define ROUND_UP(x, y) (((x) + (y) - 1) & ~((y) - 1))
+
+/**
+ * `region_alloc`
+ *
+ *   Allocates an aligned region of memory.
+ *
+ * @param len
+ *   The size of the region in bytes. It is rounded up to the size actually
+ *   allocated.
+ *
+ * @param huge
+ *   Non-zero to back the region with huge pages.
+ *
+ * @param mapped
+ *   Set to non-zero if the region was mapped rather than allocated.
+ *
+ * @return
+ *   The region, or NULL if it could not be allocated.
+ */
+static void *region_alloc(size_t * const len, const int huge,
+  int * const mapped) {
+  void *mem = NULL;
+
+  *mapped = 0;
+
+#ifdef __linux__
+  if(huge) {
+    *len = ROUND_UP(*len, HUGE_PAGE_SIZE);
+
+    /*** Try reserved huge pages first, then regular pages with a hint. ***/
+#ifdef MAP_HUGETLB
+    mem = mmap(NULL, *len, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#else
+    mem = MAP_FAILED;
+#endif
+    if(mem == MAP_FAILED) {
+      mem = mmap(NULL, *len, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+      if(mem != MAP_FAILED) {
+        madvise(mem, *len, MADV_HUGEPAGE);
+      }
+#endif
+    }
+    if(mem != MAP_FAILED) {
+      *mapped = 1;
+      return mem;
+    }
+  }
+#else
+  (void)huge;
+#endif
+
+  *len = ROUND_UP(*len, SORT_CTX_ALIGN);
+  return aligned_alloc(SORT_CTX_ALIGN, *len);
+}
+
+/**
+ * `region_free`
+ *
+ *   Frees a region allocated by `region_alloc`.
+ *
+ * @param mem
+ *   The region to be freed.
+ *
+ * @param len
+ *   The size of the region in bytes.
+ *
+ * @param mapped
+ *   Non-zero if the region was mapped rather than allocated.
+ */
+static void region_free(void * const mem, const size_t len, const int mapped) {
+#ifdef __linux__
+  if(mapped) {
+    munmap(mem, len);
+    return;
+  }
+#else
+  (void)len;
+  (void)mapped;
+#endif
+  free(mem);
+}
+
+/**
+ * `sort_ctx_init`
+ *
+ *   Initializes a sort context.
+ *
+ * @param ctx
+ *   The context to be initialized.
+ *
+ * @param len
+ *   The initial size of the arena in bytes. May be 0.
+ *
+ * @param flags
+ *   0, or `SORT_CTX_HUGE_PAGES` to back the arena with huge pages.
+ *
+ * @return
+ *   0 on success, or -1 if the arena could not be allocated.
+ */
+int sort_ctx_init(sort_ctx * const ctx, const size_t len, const int flags) {
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->flags = flags;
+  if(len > 0 && sort_ctx_scratch(ctx, len) == NULL) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * `sort_ctx_free`
+ *
+ *   Frees the memory held by a sort context.
+ *
+ * @param ctx
+ *   The context to be freed.
+ */
+void sort_ctx_free(sort_ctx * const ctx) {
+  if(ctx->arena != NULL) {
+    region_free(ctx->arena, ctx->arena_len, ctx->arena_mapped);
+  }
+  free(ctx->counts);
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+ * `sort_ctx_scratch`
+ *
+ *   Gets the arena of a sort context, growing it if it is too small.
+ *
+ *   The contents of the arena are not preserved when it grows.
+ *
+ * @param ctx
+ *   The context.
+ *
+ * @param len
+ *   The number of bytes needed.
+ *
+ * @return
+ *   The arena, or NULL if it could not be grown.
+ */
+void *sort_ctx_scratch(sort_ctx * const ctx, const size_t len) {
+  size_t size;
+  int mapped;
+  void *mem;
+
+  if(len <= ctx->arena_len) {
+    return ctx->arena;
+  }
+
+  /*** Grow by at least half of the current size, so that slowly growing ***/
+  /*** inputs do not reallocate on every call.                           ***/
+  size = ctx->arena_len + (ctx->arena_len >> 1);
+  if(size < len) {
+    size = len;
+  }
+  mem = region_alloc(&size, ctx->flags & SORT_CTX_HUGE_PAGES, &mapped);
+  if(mem == NULL) {
+    return NULL;
+  }
+
+  if(ctx->arena != NULL) {
+    region_free(ctx->arena, ctx->arena_len, ctx->arena_mapped);
+  }
+  ctx->arena = mem;
+  ctx->arena_len = size;
+  ctx->arena_mapped = mapped;
+  return mem;
+}
+
+/**
+ * `sort_ctx_counts`
+ *
+ *   Gets the counts array of a sort context, growing it if it is too small.
+ *
+ *   The contents of the counts array are not initialized.
+ *
+ * @param ctx
+ *   The context.
+ *
+ * @param len
+ *   The number of counts needed.
+ *
+ * @return
+ *   The counts array, or NULL if it could not be grown.
+ */
+size_t *sort_ctx_counts(sort_ctx * const ctx, const size_t len) {
+  size_t size;
+  size_t *mem;
+
+  if(len <= ctx->counts_len) {
+    return ctx->counts;
+  }
+
+  size = ROUND_UP(sizeof(size_t) * len, SORT_CTX_ALIGN);
+  mem = (size_t *)aligned_alloc(SORT_CTX_ALIGN, size);
+  if(mem == NULL) {
+    return NULL;
+  }
+
+  free(ctx->counts);
+  ctx->counts = mem;
+  ctx->counts_len = size / sizeof(size_t);
+  return mem;
+}
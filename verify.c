@@ -0,0 +1,419 @@
+/*******************************************************************************
+  File: verify.c
+  Author: Project contributors
+  Date created: October 19, 2026
+  Last updated: October 19, 2026
+
+  Checks that a sorting algorithm sorted an array correctly. Two things are
+  checked: that the elements are in ascending order, and that they are a
+  permutation of the elements before sorting.
+
+  The order check scans the array in blocks without branching inside a block,
+  so the compiler can vectorize it, and only looks for the exact position of
+  the first out-of-order element in the block that has one. The permutation
+  check compares fingerprints of the array taken before and after sorting. A
+  fingerprint combines the sum of the elements with the sum and the xor of a
+  hash of each element; since addition and xor do not depend on order, any two
+  permutations of the same elements have the same fingerprint, while losing or
+  duplicating an element changes it with high probability.
+
+  Large arrays are split between threads for both checks, one per processor
+  by default. A caller that already runs one check per thread, such as a
+  benchmark harness, can limit each check to its own thread.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "sort.h"
+
+/**
+ * `VERIFY_BLOCK`
+ *
+ *   Number of elements checked between early exits of the order check.
+ */
+#define VERIFY_BLOCK 4096
+
+/**
+ * `VERIFY_PARALLEL_MIN`
+ *
+ *   Smallest array that is split between threads.
+ */
+#define VERIFY_PARALLEL_MIN (1 << 20)
+
+/**
+ * `VERIFY_MAX_THREADS`
+ *
+ *   Largest number of threads used by a check.
+ */
+#define VERIFY_MAX_THREADS 64
+
+/**
+ * `chunk`
+ *
+ *   The part of an array checked by one thread.
+ */
+typedef struct {
+  const int *arr;
+  size_t len;
+  size_t unsorted;        /* Result of the order check. */
+  sort_fingerprint fp;    /* Result of the fingerprint. */
+} chunk;
+
+/**
+ * `mix`
+ *
+ *   Hashes an element with the splitmix64 finalizer.
+ *
+ * @param x
+ *   The element.
+ *
+ * @return
+ *   The hash of the element.
+ */
+static inline unsigned long long mix(const int x) {
+  unsigned long long z = (unsigned long long)(unsigned int)x
+    + 0x9E3779B97F4A7C15ULL;
+
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * `unsorted_at`
+ *
+ *   Finds the first element of an array that is less than the element before
+ *   it.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @return
+ *   The index of the first out-of-order element, or `len` if there is none.
+ */
+static size_t unsorted_at(const int * const arr, const size_t len) {
+  size_t i, j, end;
+  int bad;
+
+  for(i = 1; i < len; i = end) {
+    end = len - i > VERIFY_BLOCK ? i + VERIFY_BLOCK : len;
+
+    /*** Check the whole block without branching. ***/
+    bad = 0;
+    for(j = i; j < end; j++) {
+      bad |= arr[j - 1] > arr[j];
+    }
+
+    /*** Find the exact position in a block that is out of order. ***/
+    if(bad) {
+      for(j = i; arr[j - 1] <= arr[j]; j++);
+      return j;
+    }
+  }
+  return len;
+}
+
+/**
+ * `fingerprint_chunk`
+ *
+ *   Computes the fingerprint of an array.
+ *
+ * @param arr
+ *   The array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param fp
+ *   Set to the fingerprint.
+ */
+static void fingerprint_chunk(const int * const arr, const size_t len,
+  sort_fingerprint * const fp) {
+  size_t i;
+  unsigned long long h;
+
+  fp->sum = fp->mix_sum = fp->mix_xor = 0;
+  for(i = 0; i < len; i++) {
+    h = mix(arr[i]);
+    fp->sum += (unsigned long long)(long long)arr[i];
+    fp->mix_sum += h;
+    fp->mix_xor ^= h;
+  }
+}
+
+/**
+ * `check_chunk`
+ *
+ *   Runs the order check on a chunk.
+ *
+ * @param arg
+ *   The chunk.
+ *
+ * @return
+ *   NULL.
+ */
+static void *check_chunk(void *arg) {
+  chunk * const c = (chunk *)arg;
+
+  c->unsorted = unsorted_at(c->arr, c->len);
+  return NULL;
+}
+
+/**
+ * `fingerprint_worker`
+ *
+ *   Computes the fingerprint of a chunk.
+ *
+ * @param arg
+ *   The chunk.
+ *
+ * @return
+ *   NULL.
+ */
+static void *fingerprint_worker(void *arg) {
+  chunk * const c = (chunk *)arg;
+
+  fingerprint_chunk(c->arr, c->len, &c->fp);
+  return NULL;
+}
+
+/**
+ * `split`
+ *
+ *   Splits an array into chunks and runs a function on each of them, one per
+ *   thread.
+ *
+ * @param arr
+ *   The array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param overlap
+ *   Number of elements each chunk shares with the one before it.
+ *
+ * @param threads
+ *   The largest number of threads to use, or 0 for one per processor.
+ *
+ * @param chunks
+ *   Filled in with the chunks.
+ *
+ * @param fn
+ *   The function to run on each chunk.
+ *
+ * @return
+ *   The number of chunks.
+ */
+static size_t split(const int * const arr, const size_t len,
+  const size_t overlap, const size_t threads,
+  chunk chunks[VERIFY_MAX_THREADS], void *(*fn)(void *)) {
+  pthread_t tids[VERIFY_MAX_THREADS];
+  int started[VERIFY_MAX_THREADS];
+  size_t t, n = 1, start, end;
+  long cpus;
+
+  /*** Only use threads for large arrays. ***/
+  if(len >= VERIFY_PARALLEL_MIN) {
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    n = cpus > 1 ? (size_t)cpus : 1;
+    n = threads > 0 && threads < n ? threads : n;
+    n = n > VERIFY_MAX_THREADS ? VERIFY_MAX_THREADS : n;
+  }
+
+  for(t = 0; t < n; t++) {
+    start = len / n * t;
+    end = t == n - 1 ? len : len / n * (t + 1);
+    start = start >= overlap ? start - overlap : 0;
+    chunks[t].arr = arr + start;
+    chunks[t].len = end - start;
+  }
+
+  /*** Check the first chunk on this thread, and any chunk whose thread ***/
+  /*** could not be created.                                           ***/
+  for(t = 1; t < n; t++) {
+    started[t] = pthread_create(&tids[t], NULL, fn, &chunks[t]) == 0;
+    if(!started[t]) {
+      fn(&chunks[t]);
+    }
+  }
+  fn(&chunks[0]);
+  for(t = 1; t < n; t++) {
+    if(started[t]) {
+      pthread_join(tids[t], NULL);
+    }
+  }
+  return n;
+}
+
+/**
+ * `sorted_at`
+ *
+ *   Finds the first element of an array that is out of ascending order.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param threads
+ *   The largest number of threads to use, or 0 for one per processor.
+ *
+ * @return
+ *   The index of the first element that is less than the element before it,
+ *   or `len` if the array is sorted.
+ */
+static size_t sorted_at(const int * const arr, const size_t len,
+  const size_t threads) {
+  chunk chunks[VERIFY_MAX_THREADS];
+  size_t t, n;
+
+  /*** Each chunk overlaps the one before it by one element, so that the ***/
+  /*** pairs across the boundaries are checked.                         ***/
+  n = split(arr, len, 1, threads, chunks, check_chunk);
+  for(t = 0; t < n; t++) {
+    if(chunks[t].unsorted < chunks[t].len) {
+      return (size_t)(chunks[t].arr - arr) + chunks[t].unsorted;
+    }
+  }
+  return len;
+}
+
+/**
+ * `fingerprint`
+ *
+ *   Computes a fingerprint of the elements of an array that does not depend on
+ *   their order.
+ *
+ * @param arr
+ *   The array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param threads
+ *   The largest number of threads to use, or 0 for one per processor.
+ *
+ * @param fp
+ *   Set to the fingerprint.
+ */
+static void fingerprint(const int * const arr, const size_t len,
+  const size_t threads, sort_fingerprint * const fp) {
+  chunk chunks[VERIFY_MAX_THREADS];
+  size_t t, n;
+
+  n = split(arr, len, 0, threads, chunks, fingerprint_worker);
+  fp->sum = fp->mix_sum = fp->mix_xor = 0;
+  for(t = 0; t < n; t++) {
+    fp->sum += chunks[t].fp.sum;
+    fp->mix_sum += chunks[t].fp.mix_sum;
+    fp->mix_xor ^= chunks[t].fp.mix_xor;
+  }
+}
+
+/**
+ * `is_sorted_arr`
+ *
+ *   Finds the first element of an array that is out of ascending order.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @return
+ *   The index of the first element that is less than the element before it,
+ *   or `len` if the array is sorted.
+ */
+size_t is_sorted_arr(const int * const arr, const size_t len) {
+  return sorted_at(arr, len, 0);
+}
+
+/**
+ * `fingerprint_arr`
+ *
+ *   Computes a fingerprint of the elements of an array that does not depend on
+ *   their order.
+ *
+ * @param arr
+ *   The array.
+ *
+ * @param len
+ *   The length of the array.
+ *
+ * @param fp
+ *   Set to the fingerprint.
+ */
+void fingerprint_arr(const int * const arr, const size_t len,
+  sort_fingerprint * const fp) {
+  fingerprint(arr, len, 0, fp);
+}
+
+/**
+ * `test_arr`
+ *
+ *   Checks if an array is sorted in ascending order and, optionally, if it is
+ *   a permutation of the array it was sorted from.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *  The length of the array.
+ *
+ * @param fp
+ *   The fingerprint of the array before it was sorted, or NULL to only check
+ *   the order.
+ *
+ * @return
+ *   `TEST_OK`, `TEST_UNSORTED`, or `TEST_NOT_PERMUTATION`.
+ */
+int test_arr(const int * const arr, const size_t len,
+  const sort_fingerprint * const fp) {
+  return test_arr_threads(arr, len, fp, 0);
+}
+
+/**
+ * `test_arr_threads`
+ *
+ *   Checks if an array is sorted in ascending order and, optionally, if it is
+ *   a permutation of the array it was sorted from, with a limited number of
+ *   threads.
+ *
+ * @param arr
+ *   The array to be checked.
+ *
+ * @param len
+ *  The length of the array.
+ *
+ * @param fp
+ *   The fingerprint of the array before it was sorted, or NULL to only check
+ *   the order.
+ *
+ * @param threads
+ *   The largest number of threads to use, or 0 for one per processor.
+ *
+ * @return
+ *   `TEST_OK`, `TEST_UNSORTED`, or `TEST_NOT_PERMUTATION`.
+ */
+int test_arr_threads(const int * const arr, const size_t len,
+  const sort_fingerprint * const fp, const size_t threads) {
+  sort_fingerprint after;
+
+  if(sorted_at(arr, len, threads) < len) {
+    return TEST_UNSORTED;
+  }
+  if(fp != NULL) {
+    fingerprint(arr, len, threads, &after);
+    if(after.sum != fp->sum || after.mix_sum != fp->mix_sum
+      || after.mix_xor != fp->mix_xor) {
+      return TEST_NOT_PERMUTATION;
+    }
+  }
+  return TEST_OK;
+}